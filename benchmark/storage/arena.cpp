@@ -0,0 +1,110 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This benchmark compares iterating over objects held in a `dyno::poly` with
+// a `dyno::remote_storage` and with a `dyno::arena_storage`, after most of the
+// objects were freed at random, which fragments the memory. With the arena, it
+// also measures iterating after compacting the arena, and the cost of
+// compacting it. The memory held by the arena is reported in `reserved_bytes`.
+
+struct Entity : decltype(dyno::requires(
+  dyno::MoveConstructible{},
+  dyno::Destructible{},
+  "update"_s = dyno::method<void (float)>
+)) { };
+
+template <int N>
+struct Particle { float position = 0, velocity = N; char padding[N * 8]; };
+
+template <int N>
+auto const dyno::concept_map<Entity, Particle<N>> = dyno::make_concept_map(
+  "update"_s = [](Particle<N>& self, float dt) {
+    self.velocity += N * dt;
+    self.position += self.velocity * dt;
+  }
+);
+
+template <typename Storage>
+static std::vector<dyno::poly<Entity, Storage>> fragmented(std::size_t n) {
+  std::vector<dyno::poly<Entity, Storage>> entities;
+  auto make = [](std::size_t i) -> dyno::poly<Entity, Storage> {
+    switch (i % 3) {
+      case 0: return Particle<1>{};
+      case 1: return Particle<2>{};
+      default: return Particle<3>{};
+    }
+  };
+  for (std::size_t i = 0; i != n; ++i)
+    entities.push_back(make(i));
+
+  // Free most of the objects at random, which leaves holes between the
+  // objects that are kept.
+  std::mt19937 gen{42};
+  entities.erase(std::remove_if(entities.begin(), entities.end(), [&](auto const&) {
+    return gen() % 4 != 0;
+  }), entities.end());
+  return entities;
+}
+
+template <typename Entities>
+static void update_all(Entities& entities) {
+  for (auto& entity : entities)
+    entity.virtual_("update"_s)(0.01f);
+}
+
+static void BM_iterate_remote(benchmark::State& state) {
+  auto entities = fragmented<dyno::remote_storage>(state.range(0));
+  while (state.KeepRunning()) {
+    update_all(entities);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * entities.size());
+}
+
+static void BM_iterate_arena(benchmark::State& state) {
+  auto entities = fragmented<dyno::arena_storage<>>(state.range(0));
+  while (state.KeepRunning()) {
+    update_all(entities);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * entities.size());
+  state.counters["reserved_bytes"] = dyno::arena_storage<>::shared_arena().reserved_bytes();
+}
+
+static void BM_iterate_arena_compacted(benchmark::State& state) {
+  auto entities = fragmented<dyno::arena_storage<>>(state.range(0));
+  dyno::arena_storage<>::shared_arena().compact();
+  while (state.KeepRunning()) {
+    update_all(entities);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * entities.size());
+  state.counters["reserved_bytes"] = dyno::arena_storage<>::shared_arena().reserved_bytes();
+}
+
+static void BM_compact(benchmark::State& state) {
+  auto entities = fragmented<dyno::arena_storage<>>(state.range(0));
+  while (state.KeepRunning()) {
+    dyno::arena_storage<>::shared_arena().compact();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * entities.size());
+}
+
+BENCHMARK(BM_iterate_remote)->Arg(1000)->Arg(1000000);
+BENCHMARK(BM_iterate_arena)->Arg(1000)->Arg(1000000);
+BENCHMARK(BM_iterate_arena_compacted)->Arg(1000)->Arg(1000000);
+BENCHMARK(BM_compact)->Arg(1000)->Arg(1000000);
+BENCHMARK_MAIN();
@@ -0,0 +1,69 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno.hpp>
+#include <dyno/reclaimer.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This benchmark measures how long destroying a `dyno::poly` holding a large
+// graph takes, when the graph is destroyed right away by a
+// `dyno::remote_storage`, and when its destruction is deferred by a
+// `dyno::deferred_storage`, with the objects being reclaimed by a background
+// thread. Only the time spent destroying the `poly` is measured.
+
+struct Graph : decltype(dyno::requires(
+  dyno::MoveConstructible{},
+  dyno::Destructible{},
+  "size"_s = dyno::method<std::size_t () const>
+)) { };
+
+using Nodes = std::map<int, std::vector<int>>;
+
+template <>
+auto const dyno::concept_map<Graph, Nodes> = dyno::make_concept_map(
+  "size"_s = [](Nodes const& self) { return self.size(); }
+);
+
+static Nodes make_graph(std::size_t n) {
+  Nodes nodes;
+  for (std::size_t i = 0; i != n; ++i)
+    nodes[i] = {int(i + 1), int(i + 2)};
+  return nodes;
+}
+
+template <typename Storage>
+static void BM_destroy(benchmark::State& state) {
+  std::vector<dyno::poly<Graph, Storage>> graphs;
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    graphs.emplace_back(make_graph(state.range(0)));
+    state.ResumeTiming();
+    graphs.clear();
+  }
+}
+
+struct Background {
+  Background() { dyno::deferred_storage<Background>::shared_reclaimer().start_background_thread(); }
+};
+
+static void BM_destroy_remote(benchmark::State& state) {
+  BM_destroy<dyno::remote_storage>(state);
+}
+
+static void BM_destroy_deferred(benchmark::State& state) {
+  static Background background;
+  BM_destroy<dyno::deferred_storage<Background>>(state);
+}
+
+BENCHMARK(BM_destroy_remote)->Arg(10)->Arg(10000)->Iterations(1000)->UseRealTime();
+BENCHMARK(BM_destroy_deferred)->Arg(10)->Arg(10000)->Iterations(1000)->UseRealTime();
+BENCHMARK_MAIN();
@@ -0,0 +1,97 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This benchmark compares updating many objects of a few different types held
+// in a `dyno::poly_collection`, when the update is a method called on each
+// object, and when it is a batch function called once per type. The batch
+// function is either derived from a function taking a single object, or
+// written explicitly over the array.
+
+struct Entity : decltype(dyno::requires(
+  dyno::MoveConstructible{},
+  "update"_s = dyno::method<void (float)>,
+  "update_all"_s = dyno::batch_function<void (dyno::T*, std::size_t, float)>
+)) { };
+
+template <int N>
+struct Particle { float position = 0, velocity = N; };
+
+// The batch function is derived from the function taking a single object.
+template <int N>
+auto const dyno::concept_map<Entity, Particle<N>, std::enable_if_t<(N <= 2)>> = dyno::make_concept_map(
+  "update"_s = [](Particle<N>& self, float dt) {
+    self.velocity += N * dt;
+    self.position += self.velocity * dt;
+  },
+  "update_all"_s = [](Particle<N>& self, float dt) {
+    self.velocity += N * dt;
+    self.position += self.velocity * dt;
+  }
+);
+
+// The batch function is written over the array.
+template <int N>
+auto const dyno::concept_map<Entity, Particle<N>, std::enable_if_t<(N > 2)>> = dyno::make_concept_map(
+  "update"_s = [](Particle<N>& self, float dt) {
+    self.velocity += N * dt;
+    self.position += self.velocity * dt;
+  },
+  "update_all"_s = [](Particle<N>* first, std::size_t size, float dt) {
+    for (std::size_t i = 0; i != size; ++i) {
+      first[i].velocity += N * dt;
+      first[i].position += first[i].velocity * dt;
+    }
+  }
+);
+
+template <typename Insert>
+static void insert_entities(std::size_t n, Insert insert) {
+  std::vector<int> kinds;
+  for (std::size_t i = 0; i != n; ++i)
+    kinds.push_back(i % 4);
+  std::shuffle(kinds.begin(), kinds.end(), std::mt19937{42});
+  for (int kind : kinds) {
+    switch (kind) {
+      case 0: insert(Particle<1>{}); break;
+      case 1: insert(Particle<2>{}); break;
+      case 2: insert(Particle<3>{}); break;
+      case 3: insert(Particle<4>{}); break;
+    }
+  }
+}
+
+static void BM_method(benchmark::State& state) {
+  dyno::poly_collection<Entity> entities;
+  insert_entities(state.range(0), [&](auto entity) { entities.insert(entity); });
+  while (state.KeepRunning()) {
+    entities.invoke_each("update"_s, 0.01f);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_batch_function(benchmark::State& state) {
+  dyno::poly_collection<Entity> entities;
+  insert_entities(state.range(0), [&](auto entity) { entities.insert(entity); });
+  while (state.KeepRunning()) {
+    entities.invoke_each("update_all"_s, 0.01f);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_method)->Arg(1000)->Arg(1000000);
+BENCHMARK(BM_batch_function)->Arg(1000)->Arg(1000000);
+BENCHMARK_MAIN();
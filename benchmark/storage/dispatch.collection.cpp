@@ -0,0 +1,111 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This benchmark compares calling the same method on many objects of a few
+// different types inserted in random order, when the objects are held in a
+// `std::vector` of `dyno::poly`s and when they are held in a
+// `dyno::poly_collection`.
+
+struct Entity : decltype(dyno::requires(
+  dyno::MoveConstructible{},
+  "update"_s = dyno::method<void (float)>
+)) { };
+
+template <int N>
+struct Particle { float position = 0, velocity = N; };
+
+template <int N>
+auto const dyno::concept_map<Entity, Particle<N>> = dyno::make_concept_map(
+  "update"_s = [](Particle<N>& self, float dt) {
+    self.velocity += N * dt;
+    self.position += self.velocity * dt;
+  }
+);
+
+template <typename Insert>
+static void insert_entities(std::size_t n, Insert insert) {
+  std::vector<int> kinds;
+  for (std::size_t i = 0; i != n; ++i)
+    kinds.push_back(i % 4);
+  std::shuffle(kinds.begin(), kinds.end(), std::mt19937{42});
+  for (int kind : kinds) {
+    switch (kind) {
+      case 0: insert(Particle<1>{}); break;
+      case 1: insert(Particle<2>{}); break;
+      case 2: insert(Particle<3>{}); break;
+      case 3: insert(Particle<4>{}); break;
+    }
+  }
+}
+
+static void BM_vector_of_polys(benchmark::State& state) {
+  std::vector<dyno::poly<Entity>> entities;
+  insert_entities(state.range(0), [&](auto entity) { entities.emplace_back(entity); });
+  while (state.KeepRunning()) {
+    for (auto& entity : entities)
+      entity.virtual_("update"_s)(0.01f);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_collection_invoke_each(benchmark::State& state) {
+  dyno::poly_collection<Entity> entities;
+  insert_entities(state.range(0), [&](auto entity) { entities.insert(entity); });
+  while (state.KeepRunning()) {
+    entities.invoke_each("update"_s, 0.01f);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_collection_for_each(benchmark::State& state) {
+  dyno::poly_collection<Entity> entities;
+  insert_entities(state.range(0), [&](auto entity) { entities.insert(entity); });
+  while (state.KeepRunning()) {
+    entities.for_each([](auto& entity) { entity.virtual_("update"_s)(0.01f); });
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Calls the function in the concept map directly when the type of the object
+// is known, so that it can be inlined.
+struct update {
+  template <int N>
+  void operator()(Particle<N>& entity) const {
+    dyno::concept_map<Entity, Particle<N>>["update"_s](entity, 0.01f);
+  }
+
+  template <typename Poly>
+  void operator()(Poly& entity) const {
+    entity.virtual_("update"_s)(0.01f);
+  }
+};
+
+static void BM_collection_for_each_restituted(benchmark::State& state) {
+  dyno::poly_collection<Entity> entities;
+  insert_entities(state.range(0), [&](auto entity) { entities.insert(entity); });
+  while (state.KeepRunning()) {
+    entities.for_each<Particle<1>, Particle<2>, Particle<3>, Particle<4>>(update{});
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_vector_of_polys)->Arg(1000)->Arg(1000000);
+BENCHMARK(BM_collection_invoke_each)->Arg(1000)->Arg(1000000);
+BENCHMARK(BM_collection_for_each)->Arg(1000)->Arg(1000000);
+BENCHMARK(BM_collection_for_each_restituted)->Arg(1000)->Arg(1000000);
+BENCHMARK_MAIN();
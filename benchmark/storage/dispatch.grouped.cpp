@@ -0,0 +1,98 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This benchmark measures the benefit of grouping `poly`s by type before
+// calling the same method on many `poly`s holding objects of a few different
+// types in random order, like `benchmark/storage/dispatch.many.cpp` does with
+// two alternating types. The objects are stored inline, so that reordering
+// the `poly`s also reorders the objects.
+
+struct Entity : decltype(dyno::requires(
+  dyno::MoveConstructible{},
+  "update"_s = dyno::method<void (float)>
+)) { };
+
+template <int N>
+struct Particle { float position = 0, velocity = N; };
+
+template <int N>
+auto const dyno::concept_map<Entity, Particle<N>> = dyno::make_concept_map(
+  "update"_s = [](Particle<N>& self, float dt) {
+    self.velocity += N * dt;
+    self.position += self.velocity * dt;
+  }
+);
+
+using Poly = dyno::poly<Entity, dyno::sbo_storage<16>>;
+
+static std::vector<Poly> make_entities(std::size_t n) {
+  std::vector<Poly> entities;
+  entities.reserve(n);
+  for (std::size_t i = 0; i != n; ++i) {
+    switch (i % 4) {
+      case 0: entities.emplace_back(Particle<1>{}); break;
+      case 1: entities.emplace_back(Particle<2>{}); break;
+      case 2: entities.emplace_back(Particle<3>{}); break;
+      case 3: entities.emplace_back(Particle<4>{}); break;
+    }
+  }
+  std::shuffle(entities.begin(), entities.end(), std::mt19937{42});
+  return entities;
+}
+
+static void BM_loop(benchmark::State& state) {
+  std::vector<Poly> entities = make_entities(state.range(0));
+  while (state.KeepRunning()) {
+    for (Poly& entity : entities)
+      entity.virtual_("update"_s)(0.01f);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_invoke_each(benchmark::State& state) {
+  std::vector<Poly> entities = make_entities(state.range(0));
+  while (state.KeepRunning()) {
+    dyno::invoke_each(entities, "update"_s, 0.01f);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_partitioned_loop(benchmark::State& state) {
+  std::vector<Poly> entities = make_entities(state.range(0));
+  dyno::partition_by_type(entities);
+  while (state.KeepRunning()) {
+    for (Poly& entity : entities)
+      entity.virtual_("update"_s)(0.01f);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_partitioned_invoke_each(benchmark::State& state) {
+  std::vector<Poly> entities = make_entities(state.range(0));
+  dyno::partition_by_type(entities);
+  while (state.KeepRunning()) {
+    dyno::invoke_each(entities, "update"_s, 0.01f);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_loop)->Arg(1000)->Arg(1000000);
+BENCHMARK(BM_invoke_each)->Arg(1000)->Arg(1000000);
+BENCHMARK(BM_partitioned_loop)->Arg(1000)->Arg(1000000);
+BENCHMARK(BM_partitioned_invoke_each)->Arg(1000)->Arg(1000000);
+BENCHMARK_MAIN();
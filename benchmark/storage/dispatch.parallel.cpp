@@ -0,0 +1,98 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno.hpp>
+#include <dyno/parallel_invoke.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <thread>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This benchmark compares calling a method on many `poly`s whose cost depends
+// a lot on their type, when the `poly`s are split statically between threads
+// started for each call and when they are processed with
+// `dyno::parallel_invoke`, whose threads are only started once. The expensive
+// objects are clustered at the end of the range, which is what makes static
+// partitioning imbalanced.
+
+struct Model : decltype(dyno::requires(
+  dyno::MoveConstructible{},
+  "step"_s = dyno::method<void (double)>
+)) { };
+
+template <int Cost>
+struct Body { double state = 1; };
+
+template <int Cost>
+auto const dyno::concept_map<Model, Body<Cost>> = dyno::make_concept_map(
+  "step"_s = [](Body<Cost>& self, double dt) {
+    for (int i = 0; i != Cost; ++i)
+      self.state = self.state * (1 + dt) - dt;
+  }
+);
+
+using Poly = dyno::poly<Model>;
+
+static std::vector<Poly> make_models(std::size_t n) {
+  std::vector<Poly> models;
+  models.reserve(n);
+  for (std::size_t i = 0; i != n; ++i) {
+    if (i >= n - n / 10)
+      models.emplace_back(Body<1000>{});
+    else
+      models.emplace_back(Body<10>{});
+  }
+  return models;
+}
+
+struct range {
+  std::vector<Poly>::iterator first, last;
+  auto begin() const { return first; }
+  auto end() const { return last; }
+};
+
+static void BM_static_partition(benchmark::State& state) {
+  std::vector<Poly> models = make_models(state.range(0));
+  std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+  while (state.KeepRunning()) {
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t != threads; ++t) {
+      workers.emplace_back([&, t] {
+        auto first = models.begin() + models.size() * t / threads;
+        auto last = models.begin() + models.size() * (t + 1) / threads;
+        dyno::invoke_each(range{first, last}, "step"_s, 0.001);
+      });
+    }
+    for (std::thread& worker : workers)
+      worker.join();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_parallel_invoke(benchmark::State& state) {
+  std::vector<Poly> models = make_models(state.range(0));
+  while (state.KeepRunning())
+    dyno::parallel_invoke(models.begin(), models.end(), "step"_s, 0.001);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_parallel_invoke_grouped(benchmark::State& state) {
+  std::vector<Poly> models = make_models(state.range(0));
+  dyno::parallel_options options;
+  options.group_by_type = true;
+  while (state.KeepRunning())
+    dyno::parallel_invoke(options, models.begin(), models.end(), "step"_s, 0.001);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_static_partition)->Arg(100000)->UseRealTime();
+BENCHMARK(BM_parallel_invoke)->Arg(100000)->UseRealTime();
+BENCHMARK(BM_parallel_invoke_grouped)->Arg(100000)->UseRealTime();
+BENCHMARK_MAIN();
@@ -0,0 +1,133 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This benchmark compares keeping objects identified by ids in a
+// `std::unordered_map` from ids to `dyno::poly`s, and keeping them in a
+// `dyno::poly_slot_map`. It measures looking up objects by id in random
+// order, iterating over all the objects, and churning, i.e. erasing and
+// inserting objects.
+
+struct Entity : decltype(dyno::requires(
+  dyno::MoveConstructible{},
+  "update"_s = dyno::method<void (float)>
+)) { };
+
+template <int N>
+struct Particle { float position = 0, velocity = N; };
+
+template <int N>
+auto const dyno::concept_map<Entity, Particle<N>> = dyno::make_concept_map(
+  "update"_s = [](Particle<N>& self, float dt) {
+    self.velocity += N * dt;
+    self.position += self.velocity * dt;
+  }
+);
+
+template <typename Insert>
+static void insert_entities(std::size_t n, Insert insert) {
+  for (std::size_t i = 0; i != n; ++i) {
+    switch (i % 3) {
+      case 0: insert(Particle<1>{}); break;
+      case 1: insert(Particle<2>{}); break;
+      case 2: insert(Particle<3>{}); break;
+    }
+  }
+}
+
+template <typename Id>
+static std::vector<Id> shuffled(std::vector<Id> ids) {
+  std::shuffle(ids.begin(), ids.end(), std::mt19937{42});
+  return ids;
+}
+
+struct unordered_map_of_polys {
+  using Id = std::uint32_t;
+  std::unordered_map<Id, dyno::poly<Entity>> entities;
+  Id next = 0;
+
+  template <typename T>
+  Id insert(T entity) { entities.emplace(next, entity); return next++; }
+  void erase(Id id) { entities.erase(id); }
+  void update(Id id) { entities.find(id)->second.virtual_("update"_s)(0.01f); }
+  void update_all() {
+    for (auto& entity : entities)
+      entity.second.virtual_("update"_s)(0.01f);
+  }
+};
+
+struct slot_map {
+  using Id = dyno::poly_slot_map<Entity>::handle;
+  dyno::poly_slot_map<Entity> entities;
+
+  template <typename T>
+  Id insert(T entity) { return entities.insert(entity); }
+  void erase(Id id) { entities.erase(id); }
+  void update(Id id) {
+    auto entity = entities[id];
+    entity.virtual_("update"_s)(0.01f);
+  }
+  void update_all() { dyno::invoke_each(entities, "update"_s, 0.01f); }
+};
+
+template <typename Container>
+static void BM_lookup(benchmark::State& state) {
+  Container c;
+  std::vector<typename Container::Id> ids;
+  insert_entities(state.range(0), [&](auto entity) { ids.push_back(c.insert(entity)); });
+  ids = shuffled(ids);
+  while (state.KeepRunning()) {
+    for (auto id : ids)
+      c.update(id);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Container>
+static void BM_iterate(benchmark::State& state) {
+  Container c;
+  insert_entities(state.range(0), [&](auto entity) { c.insert(entity); });
+  while (state.KeepRunning()) {
+    c.update_all();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Container>
+static void BM_churn(benchmark::State& state) {
+  Container c;
+  std::vector<typename Container::Id> ids;
+  insert_entities(state.range(0), [&](auto entity) { ids.push_back(c.insert(entity)); });
+  ids = shuffled(ids);
+  std::size_t next = 0;
+  while (state.KeepRunning()) {
+    for (int i = 0; i != 100; ++i) {
+      c.erase(ids[next]);
+      ids[next] = c.insert(Particle<2>{});
+      next = (next + 1) % ids.size();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 100);
+}
+
+BENCHMARK_TEMPLATE(BM_lookup, unordered_map_of_polys)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_lookup, slot_map)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_iterate, unordered_map_of_polys)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_iterate, slot_map)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_churn, unordered_map_of_polys)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_churn, slot_map)->Arg(1000)->Arg(1000000);
+BENCHMARK_MAIN();
@@ -0,0 +1,85 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This benchmark compares filling and then walking through a sequence of small
+// objects of different sizes (like the events of a log), when they are held in
+// a `std::vector` of `dyno::poly`s using various storage policies, and when
+// they are held in a `dyno::poly_vector`.
+
+struct Event : decltype(dyno::requires(
+  dyno::MoveConstructible{},
+  "hash"_s = dyno::method<std::uint64_t () const>
+)) { };
+
+struct Click { std::uint8_t button; };
+struct Key { std::uint16_t code; };
+struct Move { std::int32_t x, y; };
+struct Scroll { double dx, dy; };
+
+template <typename T>
+auto const dyno::default_concept_map<Event, T> = dyno::make_concept_map(
+  "hash"_s = [](T const& self) {
+    std::uint64_t h = 0;
+    unsigned char const* bytes = reinterpret_cast<unsigned char const*>(&self);
+    for (std::size_t i = 0; i != sizeof(T); ++i)
+      h = h * 31 + bytes[i];
+    return h;
+  }
+);
+
+template <typename Sequence>
+static void fill(Sequence& events, std::size_t n) {
+  for (std::size_t i = 0; i != n; ++i) {
+    switch (i % 4) {
+      case 0: events.push_back(Click{std::uint8_t(i)}); break;
+      case 1: events.push_back(Key{std::uint16_t(i)}); break;
+      case 2: events.push_back(Move{int(i), int(i)}); break;
+      case 3: events.push_back(Scroll{double(i), double(i)}); break;
+    }
+  }
+}
+
+template <typename Sequence>
+static void BM_fill(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    Sequence events;
+    fill(events, state.range(0));
+    benchmark::DoNotOptimize(events);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Sequence>
+static void BM_walk(benchmark::State& state) {
+  Sequence events;
+  fill(events, state.range(0));
+  while (state.KeepRunning()) {
+    std::uint64_t h = 0;
+    for (auto&& event : events)
+      h += event.virtual_("hash"_s)();
+    benchmark::DoNotOptimize(h);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+using remote = std::vector<dyno::poly<Event, dyno::remote_storage>>;
+using sbo = std::vector<dyno::poly<Event, dyno::sbo_storage<16>>>;
+using packed = dyno::poly_vector<Event>;
+
+BENCHMARK_TEMPLATE(BM_fill, remote)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_fill, sbo)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_fill, packed)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_walk, remote)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_walk, sbo)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_walk, packed)->Arg(1000)->Arg(1000000);
+BENCHMARK_MAIN();
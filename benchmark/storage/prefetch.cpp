@@ -0,0 +1,91 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This benchmark measures the benefit of prefetching the objects and the
+// vtables of `poly`s using `dyno::remote_storage` while iterating over them,
+// using `dyno::prefetching` with various distances. The objects are allocated
+// one after the other, but the `poly`s are then shuffled, so the objects are
+// visited in an order the hardware prefetcher can't predict.
+
+struct Entity : decltype(dyno::requires(
+  dyno::MoveConstructible{},
+  "update"_s = dyno::method<void (float)>
+)) { };
+
+template <int N>
+struct Particle { float position = 0, velocity = N; };
+
+template <int N>
+auto const dyno::concept_map<Entity, Particle<N>> = dyno::make_concept_map(
+  "update"_s = [](Particle<N>& self, float dt) {
+    self.velocity += N * dt;
+    self.position += self.velocity * dt;
+  }
+);
+
+using Poly = dyno::poly<Entity, dyno::remote_storage>;
+
+static std::vector<Poly> const& entities() {
+  static std::vector<Poly> const result = [] {
+    std::vector<Poly> entities;
+    std::size_t const n = 10000000;
+    entities.reserve(n);
+    for (std::size_t i = 0; i != n; ++i) {
+      switch (i % 4) {
+        case 0: entities.emplace_back(Particle<1>{}); break;
+        case 1: entities.emplace_back(Particle<2>{}); break;
+        case 2: entities.emplace_back(Particle<3>{}); break;
+        case 3: entities.emplace_back(Particle<4>{}); break;
+      }
+    }
+    std::shuffle(entities.begin(), entities.end(), std::mt19937{42});
+    return entities;
+  }();
+  return result;
+}
+
+static void BM_loop(benchmark::State& state) {
+  auto& polys = const_cast<std::vector<Poly>&>(entities());
+  while (state.KeepRunning()) {
+    for (Poly& poly : polys)
+      poly.virtual_("update"_s)(0.01f);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * polys.size());
+}
+
+static void BM_prefetching(benchmark::State& state) {
+  auto& polys = const_cast<std::vector<Poly>&>(entities());
+  while (state.KeepRunning()) {
+    for (Poly& poly : dyno::prefetching(polys, state.range(0)))
+      poly.virtual_("update"_s)(0.01f);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * polys.size());
+}
+
+static void BM_invoke_each_prefetching(benchmark::State& state) {
+  auto& polys = const_cast<std::vector<Poly>&>(entities());
+  while (state.KeepRunning()) {
+    dyno::invoke_each(dyno::prefetching(polys, state.range(0)), "update"_s, 0.01f);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * polys.size());
+}
+
+BENCHMARK(BM_loop)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_prefetching)->Arg(4)->Arg(8)->Arg(16)->Arg(32)->Arg(64)->Arg(128)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_invoke_each_prefetching)->Arg(32)->Unit(benchmark::kMillisecond);
+BENCHMARK_MAIN();
@@ -0,0 +1,76 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This benchmark measures the cost of filtering a sequence of type-erased
+// objects on one of their data members, when that member is read through
+// a getter function in the vtable and when it is read through a field.
+
+struct GetterConcept : decltype(dyno::requires(
+  dyno::MoveConstructible{},
+  "id"_s = dyno::function<int (dyno::T const&)>
+)) { };
+
+struct FieldConcept : decltype(dyno::requires(
+  dyno::MoveConstructible{},
+  "id"_s = dyno::field<int>
+)) { };
+
+struct A { int id; double x; };
+struct B { double y; int id; };
+
+template <>
+auto const dyno::concept_map<GetterConcept, A> = dyno::make_concept_map(
+  "id"_s = [](A const& a) { return a.id; }
+);
+template <>
+auto const dyno::concept_map<GetterConcept, B> = dyno::make_concept_map(
+  "id"_s = [](B const& b) { return b.id; }
+);
+
+template <>
+auto const dyno::concept_map<FieldConcept, A> = dyno::make_concept_map(
+  "id"_s = DYNO_FIELD(A, id)
+);
+template <>
+auto const dyno::concept_map<FieldConcept, B> = dyno::make_concept_map(
+  "id"_s = DYNO_FIELD(B, id)
+);
+
+template <typename Poly>
+int get_id(Poly const& p, dyno::function_t<int (dyno::T const&)>)
+{ return p.virtual_("id"_s)(p); }
+
+template <typename Poly>
+int get_id(Poly const& p, dyno::field_t<int>)
+{ return p.virtual_("id"_s); }
+
+template <typename Concept>
+static void BM_filter(benchmark::State& state) {
+  using Poly = dyno::poly<Concept, dyno::sbo_storage<16>>;
+  std::vector<Poly> objects;
+  for (int i = 0; i != state.range(0); ++i) {
+    if (i % 2) objects.emplace_back(A{i, 0.0});
+    else       objects.emplace_back(B{0.0, i});
+  }
+
+  while (state.KeepRunning()) {
+    std::size_t count = 0;
+    for (Poly const& p : objects)
+      count += get_id(p, Concept{}.get_signature("id"_s)) % 3 == 0;
+    benchmark::DoNotOptimize(count);
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_filter, GetterConcept)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_filter, FieldConcept)->Arg(1000);
+BENCHMARK_MAIN();
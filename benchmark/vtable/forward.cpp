@@ -0,0 +1,62 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <utility>
+using namespace dyno::literals;
+
+
+// This benchmark measures the overhead of passing an argument that is
+// expensive to copy by value through a virtual function. The number of
+// copies and moves per call are reported, and should be at most one each.
+
+static long copies = 0;
+static long moves = 0;
+
+struct Argument {
+  Argument() = default;
+  Argument(Argument const& other) : payload{other.payload} { ++copies; }
+  Argument(Argument&& other) : payload{std::move(other.payload)} { ++moves; }
+  std::string payload = std::string(64, 'x');
+};
+
+struct Concept : decltype(dyno::requires(
+  "f"_s = dyno::method<std::size_t (Argument) const>
+)) { };
+
+struct Model { };
+
+template <>
+auto const dyno::concept_map<Concept, Model> = dyno::make_concept_map(
+  "f"_s = [](Model const&, Argument a) { return a.payload.size(); }
+);
+
+template <typename MakeArgument>
+static void run(benchmark::State& state, MakeArgument make) {
+  dyno::poly<Concept> poly{Model{}};
+  Argument argument;
+  copies = moves = 0;
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(poly);
+    benchmark::DoNotOptimize(poly.virtual_("f"_s)(make(argument)));
+  }
+  state.counters["copies"] = benchmark::Counter(copies, benchmark::Counter::kAvgIterations);
+  state.counters["moves"] = benchmark::Counter(moves, benchmark::Counter::kAvgIterations);
+}
+
+static void BM_lvalue(benchmark::State& state) {
+  run(state, [](Argument& a) -> Argument& { return a; });
+}
+
+static void BM_rvalue(benchmark::State& state) {
+  run(state, [](Argument& a) -> Argument&& { return std::move(a); });
+}
+
+BENCHMARK(BM_lvalue);
+BENCHMARK(BM_rvalue);
+BENCHMARK_MAIN();
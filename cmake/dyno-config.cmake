@@ -5,6 +5,7 @@
 include(CMakeFindDependencyMacro)
 find_dependency(Hana REQUIRED)
 find_dependency(CallableTraits REQUIRED)
+find_dependency(Threads REQUIRED) # for Dyno::parallel
 
 if(NOT TARGET Dyno::dyno)
   include("${CMAKE_CURRENT_LIST_DIR}/dyno-targets.cmake")
@@ -108,6 +108,19 @@ int main() {
     DYNO_CHECK(*first == 3);
   }
 
+  ////////////////////////////////////////////////////////////////////////////
+  // Advancing a copy
+  ////////////////////////////////////////////////////////////////////////////
+  {
+    using Iterator = any_iterator<int, std::random_access_iterator_tag>;
+    std::vector<int> input{1, 2, 3, 4};
+    Iterator first{input.begin()};
+    Iterator third = first + 2;
+    DYNO_CHECK(*first == 1);
+    DYNO_CHECK(*third == 3);
+    DYNO_CHECK(third + 2 == Iterator{input.end()});
+  }
+
   ////////////////////////////////////////////////////////////////////////////
   // Swap
   ////////////////////////////////////////////////////////////////////////////
@@ -50,7 +50,8 @@ template <typename Reference, typename Difference>
 struct RandomAccessIterator : decltype(dyno::requires(
   BidirectionalIterator<Reference>{},
   "advance"_s = dyno::function<void (dyno::T&, Difference)>,
-  "distance"_s = dyno::function<Difference (dyno::T const&, dyno::T const&)>
+  "distance"_s = dyno::function<Difference (dyno::T const&, dyno::T const&)>,
+  "next"_s = dyno::function<dyno::T (dyno::T const&, Difference)>
 )) { };
 
 
@@ -76,6 +77,10 @@ auto const dyno::default_concept_map<RandomAccessIterator<Ref, Diff>, T> = dyno:
 
   "distance"_s = [](T const& first, T const& last) -> Diff {
     return std::distance(first, last);
+  },
+
+  "next"_s = [](T const& self, Diff diff) -> T {
+    return std::next(self, diff);
   }
 );
 
@@ -132,7 +137,13 @@ private:
   ));
 
   using Storage = dyno::local_storage<8>;
-  dyno::poly<ActualConcept, Storage> poly_;
+  using Poly = dyno::poly<ActualConcept, Storage>;
+  Poly poly_;
+
+  struct from_poly_t { };
+  any_iterator(from_poly_t, Poly&& poly)
+    : poly_{std::move(poly)}
+  { }
 
 public:
   template <typename It>
@@ -187,6 +198,14 @@ public:
     return *this;
   }
 
+  // The advanced iterator is constructed directly inside the storage of the
+  // new `poly`, without creating a temporary wrapper.
+  template <bool True = true, typename = std::enable_if_t<True &&
+    std::is_base_of<std::random_access_iterator_tag, iterator_category>{}
+  >> any_iterator operator+(difference_type n) const {
+    return any_iterator{from_poly_t{}, poly_.virtual_("next"_s)(poly_, n)};
+  }
+
   reference operator*() {
     return poly_.virtual_("dereference"_s)(poly_);
   }
@@ -5,11 +5,17 @@
 #ifndef DYNO_HPP
 #define DYNO_HPP
 
+#include <dyno/algorithm.hpp>
+#include <dyno/arena.hpp>
 #include <dyno/builtin.hpp>
 #include <dyno/concept.hpp>
 #include <dyno/concept_map.hpp>
+#include <dyno/dispatch_table.hpp>
 #include <dyno/macro.hpp>
 #include <dyno/poly.hpp>
+#include <dyno/poly_collection.hpp>
+#include <dyno/poly_slot_map.hpp>
+#include <dyno/poly_vector.hpp>
 #include <dyno/storage.hpp>
 #include <dyno/vtable.hpp>
 
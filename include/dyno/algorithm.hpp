@@ -0,0 +1,256 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#ifndef DYNO_ALGORITHM_HPP
+#define DYNO_ALGORITHM_HPP
+
+#include <dyno/detail/poly_access.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace dyno {
+
+namespace detail {
+  // Assigns a group to each key, in order of first appearance of the keys.
+  // There are usually very few groups and the keys are often in random order,
+  // so the first groups are searched without branching on each comparison,
+  // and a hash table is only used when there are more groups.
+  template <typename Key>
+  struct group_by {
+    std::size_t operator()(Key key) {
+      if (keys_.size() <= linear_groups) {
+        std::size_t group = keys_.size();
+        for (std::size_t i = 0; i != keys_.size(); ++i)
+          group = keys_[i] == key ? i : group;
+        if (group != keys_.size())
+          return group;
+      } else {
+        auto it = index_.find(key);
+        if (it != index_.end())
+          return it->second;
+      }
+
+      std::size_t group = keys_.size();
+      keys_.push_back(key);
+      if (keys_.size() == linear_groups + 1) {
+        for (std::size_t i = 0; i != keys_.size(); ++i)
+          index_.emplace(keys_[i], i);
+      } else if (keys_.size() > linear_groups + 1) {
+        index_.emplace(key, group);
+      }
+      return group;
+    }
+
+    // Returns the number of groups, and the key of the given group.
+    std::size_t size() const { return keys_.size(); }
+    Key const& key(std::size_t group) const { return keys_[group]; }
+
+  private:
+    static constexpr std::size_t linear_groups = 16;
+    std::vector<Key> keys_;
+    std::unordered_map<Key, std::size_t> index_;
+  };
+} // end namespace detail
+
+// Calls the function with the given name on each `dyno::poly` in the given
+// range, with the given arguments.
+//
+// The `poly`s are grouped by the function found in their vtable (which is
+// usually the same as grouping them by type), and the function is then called
+// on each `poly` of a group in a loop where the function never changes, so the
+// indirect call is always predicted correctly. The calls on the `poly`s of a
+// group are made in the order of the range, but the order of the calls on
+// `poly`s of different groups is unspecified.
+//
+// As long as each run of consecutive `poly`s holding objects of the same type
+// is the first run of that type, the calls are made directly while going
+// through the range. After that, the iterators to the remaining `poly`s are
+// put in a bucket per group, and the buckets are processed one after the
+// other. When the same range is processed repeatedly, it is cheaper to group
+// the `poly`s once in place with `dyno::partition_by_type`, in which case no
+// bucket is needed and the objects are accessed in order.
+//
+// The function must be a method, or a function whose first parameter is a
+// placeholder (in which case the `poly` is passed as that parameter), like
+// for `dyno::poly::bind`. Since they are passed to each call, the arguments
+// are always passed as lvalues, and the results of the calls are discarded.
+template <typename Range, typename Function, typename ...Args>
+void invoke_each(Range&& range, Function name, Args&& ...args) {
+  using Iterator = decltype(std::begin(range));
+  using FunctionPtr = decltype(detail::poly_access::lookup(*std::begin(range), name));
+  auto call = [&](Iterator position, FunctionPtr fptr) {
+    // The range may yield references to the objects (like `dyno::poly_ref`)
+    // by value instead of `poly`s.
+    auto&& poly = *position;
+    detail::poly_access::bind(poly, name, fptr)(args...);
+  };
+
+  detail::group_by<FunctionPtr> group_of;
+  auto first = std::begin(range);
+  auto last = std::end(range);
+  while (first != last) {
+    FunctionPtr fptr = detail::poly_access::lookup(*first, name);
+    std::size_t groups = group_of.size();
+    if (group_of(fptr) != groups)
+      break;
+    do {
+      call(first, fptr);
+      ++first;
+    } while (first != last && detail::poly_access::lookup(*first, name) == fptr);
+  }
+  if (first == last)
+    return;
+
+  std::vector<std::vector<Iterator>> buckets(group_of.size());
+  for (; first != last; ++first) {
+    std::size_t group = group_of(detail::poly_access::lookup(*first, name));
+    if (group == buckets.size())
+      buckets.emplace_back();
+    buckets[group].push_back(first);
+  }
+  for (std::size_t group = 0; group != buckets.size(); ++group) {
+    FunctionPtr fptr = group_of.key(group);
+    for (Iterator position : buckets[group])
+      call(position, fptr);
+  }
+}
+
+namespace detail {
+  template <typename Iterator>
+  struct prefetching_iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename std::iterator_traits<Iterator>::value_type;
+    using reference = typename std::iterator_traits<Iterator>::reference;
+    using pointer = typename std::iterator_traits<Iterator>::pointer;
+    using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+
+    prefetching_iterator(Iterator current, Iterator ahead, Iterator last)
+      : current_{current}, ahead_{ahead}, last_{last}
+    { }
+
+    reference operator*() const { return *current_; }
+
+    prefetching_iterator& operator++() {
+      ++current_;
+      if (ahead_ != last_) {
+        detail::poly_access::prefetch(*ahead_);
+        ++ahead_;
+      }
+      return *this;
+    }
+
+    prefetching_iterator operator++(int) {
+      prefetching_iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    friend bool operator==(prefetching_iterator const& a, prefetching_iterator const& b)
+    { return a.current_ == b.current_; }
+    friend bool operator!=(prefetching_iterator const& a, prefetching_iterator const& b)
+    { return a.current_ != b.current_; }
+
+  private:
+    Iterator current_, ahead_, last_;
+  };
+
+  template <typename Iterator>
+  struct prefetching_range {
+    // The first `distance` elements are prefetched when starting to iterate.
+    prefetching_iterator<Iterator> begin() const {
+      Iterator ahead = first;
+      for (std::size_t i = 0; i != distance && ahead != last; ++i, ++ahead)
+        detail::poly_access::prefetch(*ahead);
+      return {first, ahead, last};
+    }
+
+    prefetching_iterator<Iterator> end() const { return {last, last, last}; }
+
+    Iterator first, last;
+    std::size_t distance;
+  };
+} // end namespace detail
+
+// Returns a view of the given range of `dyno::poly`s, which prefetches the
+// object held by the `poly` (and its vtable, when it is stored remotely)
+// `distance` elements ahead of the current one while iterating.
+//
+// When the objects are allocated on the heap (e.g. with `dyno::remote_storage`)
+// and the range is large, each call made in a loop over the `poly`s usually
+// has to wait for the object and the vtable to be loaded from memory, since
+// the hardware can't guess their address. Prefetching them early lets these
+// loads overlap with the previous calls. The best distance depends on the
+// cost of the calls and on the machine; `benchmark/storage/prefetch.cpp` can
+// be used to tune it. Prefetching too close is useless, since the loads don't
+// complete before they are needed.
+//
+// The view can be iterated over many times, like the underlying range, which
+// must outlive the view. It can also be passed to `dyno::invoke_each`.
+template <typename Range>
+auto prefetching(Range&& range, std::size_t distance = 32) {
+  using Iterator = decltype(std::begin(range));
+  return detail::prefetching_range<Iterator>{std::begin(range), std::end(range), distance};
+}
+
+// Reorders the given `dyno::poly`s so that `poly`s holding objects of the same
+// type are next to each other. The groups of `poly`s appear in the order in
+// which their type first appears in the vector, but the order of the `poly`s
+// within a group is unspecified.
+//
+// This is the in-place variant of the grouping done by `dyno::invoke_each`:
+// the `poly`s are swapped in place, in linear time. Afterwards, as long as the
+// vector is not modified, calling the same function on each `poly` of the
+// vector in a plain loop mispredicts only at the boundaries between groups,
+// and `dyno::invoke_each` does not need any bucket. The vtable of the `poly`s
+// must be able to identify the concept map it was created from (see the
+// `VTable` concept), which is the case whenever some of their functions are
+// stored remotely.
+template <typename Poly, typename Allocator>
+void partition_by_type(std::vector<Poly, Allocator>& polys) {
+  detail::group_by<void const*> group_of;
+  std::vector<std::size_t> groups(polys.size());
+  std::vector<std::size_t> ends;
+  for (std::size_t i = 0; i != polys.size(); ++i) {
+    groups[i] = group_of(detail::poly_access::concept_map_id(polys[i]));
+    if (groups[i] == ends.size())
+      ends.push_back(0);
+    ++ends[groups[i]];
+  }
+
+  // `next[g]` is the position where the next `poly` of group `g` goes, and
+  // `ends[g]` is the end of group `g`.
+  std::vector<std::size_t> next(ends.size());
+  for (std::size_t group = 0, end = 0; group != ends.size(); ++group) {
+    next[group] = end;
+    end += ends[group];
+    ends[group] = end;
+  }
+
+  // Swap each `poly` to the next position of its group, until each position
+  // of the current group holds a `poly` of that group.
+  using std::swap;
+  for (std::size_t group = 0; group != ends.size(); ++group) {
+    while (next[group] != ends[group]) {
+      std::size_t i = next[group];
+      std::size_t other = groups[i];
+      if (other == group) {
+        ++next[group];
+      } else {
+        std::size_t j = next[other]++;
+        swap(polys[i], polys[j]);
+        swap(groups[i], groups[j]);
+      }
+    }
+  }
+}
+
+} // end namespace dyno
+
+#endif // DYNO_ALGORITHM_HPP
@@ -0,0 +1,365 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#ifndef DYNO_ARENA_HPP
+#define DYNO_ARENA_HPP
+
+#include <dyno/builtin.hpp>
+#include <dyno/storage.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace dyno {
+
+// Memory region where objects of arbitrary types are allocated next to each
+// other, in large blocks, and which can be compacted to reclaim the memory
+// left unused by the objects that were freed.
+//
+// Each object is preceded by a small header recording its size, how to
+// relocate it, and where the pointer to the object is stored by its owner
+// (usually a `dyno::arena_storage`). When compacting the arena, the live
+// objects are relocated to new blocks, one after the other, the owners'
+// pointers are updated to point to the new location of their object, and
+// the old blocks are released. A block is also released as soon as all the
+// objects allocated in it are freed.
+//
+// An arena is not thread-safe; it must only be used from one thread at a
+// time, including through the storages allocating from it.
+//
+// The objects must be relocatable without throwing, so that compacting the
+// arena can't fail half-way.
+//
+// TODO:
+// - Compacting requires enough memory for the old and the new blocks at the
+//   same time; objects could be relocated within their block instead.
+// - Support over-aligned types.
+class arena {
+public:
+  // Moves the object at `from` to the uninitialized memory at `to`, and ends
+  // the lifetime of the object at `from`, without throwing. A null function
+  // means that the object can be relocated by copying its bytes.
+  using relocate_function = void (*)(void* to, void* from);
+
+  explicit arena(std::size_t block_size = 64 * 1024)
+    : block_size_{block_size}
+  { }
+
+  arena(arena const&) = delete;
+  arena& operator=(arena const&) = delete;
+
+  // All the objects must have been freed already.
+  ~arena() {
+    assert(used_bytes_ == 0 && "dyno::arena: The arena is destroyed while objects are still alive.");
+    for (block* b : blocks_)
+      std::free(b);
+  }
+
+  // Allocates memory for an object of the given size, and records the way to
+  // relocate it and the address where its owner stores the pointer to it.
+  void* allocate(std::size_t size, relocate_function relocate, void** owner) {
+    std::size_t total = arena::total_size(size);
+    if (blocks_.empty() || blocks_.back()->capacity - blocks_.back()->used < total)
+      this->add_block(std::max(block_size_, total));
+
+    return this->allocate_in(blocks_.back(), size, relocate, owner);
+  }
+
+  // Frees the memory of an object, which must have been destroyed already.
+  void deallocate(void* object) {
+    header* h = arena::header_of(object);
+    block* b = h->owner_block;
+    h->owner = nullptr;
+    used_bytes_ -= arena::total_size(h->size);
+    if (--b->live != 0)
+      return;
+
+    // The last block is reused for future allocations, while the others are
+    // released right away.
+    if (b == blocks_.back()) {
+      b->used = 0;
+    } else {
+      blocks_.erase(std::find(blocks_.begin(), blocks_.end(), b));
+      reserved_bytes_ -= b->capacity;
+      std::free(b);
+    }
+  }
+
+  // Records a new address where the owner of the object stores the pointer
+  // to it, for example when that owner is moved.
+  static void set_owner(void* object, void** owner) {
+    arena::header_of(object)->owner = owner;
+  }
+
+  static std::size_t size_of(void const* object) {
+    return arena::header_of(object)->size;
+  }
+
+  static relocate_function relocator_of(void const* object) {
+    return arena::header_of(object)->relocate;
+  }
+
+  // Relocates all the live objects next to each other in new blocks, updates
+  // the pointers held by their owners, and releases the old blocks. This
+  // invalidates all the pointers and references to the objects of the arena,
+  // other than the ones held by their owners.
+  //
+  // The new blocks are all allocated before any object is relocated, so the
+  // arena is left unchanged if that throws.
+  void compact() {
+    std::vector<block*> old;
+    old.swap(blocks_);
+    std::size_t const reserved = reserved_bytes_;
+    reserved_bytes_ = 0;
+    try {
+      std::size_t room = 0;
+      arena::for_each_live(old, [&](header* h) {
+        std::size_t total = arena::total_size(h->size);
+        if (room < total) {
+          this->add_block(std::max(block_size_, total));
+          room = blocks_.back()->capacity;
+        }
+        room -= total;
+      });
+    } catch (...) {
+      old.swap(blocks_);
+      for (block* b : old)
+        std::free(b);
+      reserved_bytes_ = reserved;
+      throw;
+    }
+
+    used_bytes_ = 0;
+    std::size_t next = 0;
+    arena::for_each_live(old, [&](header* h) {
+      block* b = blocks_[next];
+      if (b->capacity - b->used < arena::total_size(h->size))
+        b = blocks_[++next];
+      void* from = arena::object_of(h);
+      void* to = this->allocate_in(b, h->size, h->relocate, h->owner);
+      if (h->relocate == nullptr)
+        std::memcpy(to, from, h->size);
+      else
+        h->relocate(to, from);
+      *h->owner = to;
+    });
+    for (block* b : old)
+      std::free(b);
+  }
+
+  // Returns the number of bytes used by the live objects, including their
+  // headers and padding, and the number of bytes held in blocks.
+  std::size_t used_bytes() const { return used_bytes_; }
+  std::size_t reserved_bytes() const { return reserved_bytes_; }
+
+private:
+  static constexpr std::size_t alignment = alignof(std::max_align_t);
+
+  static constexpr std::size_t round_up(std::size_t size)
+  { return (size + alignment - 1) / alignment * alignment; }
+
+  struct block {
+    std::size_t capacity; // bytes available for allocations
+    std::size_t used;     // bytes allocated so far, including freed objects
+    std::size_t live;     // number of objects that were not freed yet
+
+    char* data() { return reinterpret_cast<char*>(this) + arena::round_up(sizeof(block)); }
+  };
+
+  struct header {
+    block* owner_block;
+    void** owner; // null once the object is freed
+    std::size_t size;
+    relocate_function relocate;
+  };
+
+  static constexpr std::size_t total_size(std::size_t size)
+  { return arena::round_up(sizeof(header)) + arena::round_up(size); }
+
+  static void* object_of(header* h)
+  { return reinterpret_cast<char*>(h) + arena::round_up(sizeof(header)); }
+
+  static header* header_of(void const* object) {
+    char const* h = static_cast<char const*>(object) - arena::round_up(sizeof(header));
+    return reinterpret_cast<header*>(const_cast<char*>(h));
+  }
+
+  // Allocates memory for an object in the given block, which must have room
+  // for it.
+  void* allocate_in(block* b, std::size_t size, relocate_function relocate, void** owner) {
+    std::size_t total = arena::total_size(size);
+    header* h = new (b->data() + b->used) header{b, owner, size, relocate};
+    b->used += total;
+    ++b->live;
+    used_bytes_ += total;
+    return arena::object_of(h);
+  }
+
+  // Calls `f` with the header of each object that was not freed in the given
+  // blocks, in order.
+  template <typename F>
+  static void for_each_live(std::vector<block*> const& blocks, F&& f) {
+    for (block* b : blocks) {
+      for (std::size_t offset = 0; offset != b->used; ) {
+        header* h = reinterpret_cast<header*>(b->data() + offset);
+        offset += arena::total_size(h->size);
+        if (h->owner != nullptr)
+          f(h);
+      }
+    }
+  }
+
+  void add_block(std::size_t capacity) {
+    blocks_.reserve(blocks_.size() + 1);
+    void* memory = std::malloc(arena::round_up(sizeof(block)) + capacity);
+    if (memory == nullptr)
+      throw std::bad_alloc{};
+    blocks_.push_back(new (memory) block{capacity, 0, 0});
+    reserved_bytes_ += capacity;
+  }
+
+  std::size_t block_size_;
+  std::vector<block*> blocks_;
+  std::size_t used_bytes_ = 0;
+  std::size_t reserved_bytes_ = 0;
+};
+
+// Class implementing storage in a `dyno::arena`, which is shared by all the
+// `arena_storage`s with the same `Tag`.
+//
+// Like `dyno::remote_storage`, the storage only holds a pointer to its
+// object, but the object is allocated in the arena instead of on the heap.
+// When the arena is compacted with `arena_storage<Tag>::shared_arena().compact()`,
+// the objects are relocated and the storages are updated to point to their
+// new location, which reclaims the memory fragmented by freed objects. The
+// objects are relocated by copying their bytes when they are trivially
+// relocatable (see `dyno::is_trivially_relocatable`), and with their move
+// constructor and destructor otherwise, in which case the move constructor
+// must not throw.
+//
+// Since the arena keeps track of where each storage is, it must not be copied
+// byte by byte. Also, the arena is not thread-safe, so all the storages with
+// the same `Tag` must be used from one thread at a time.
+template <typename Tag = void>
+struct arena_storage {
+  arena_storage() = delete;
+  arena_storage(arena_storage const&) = delete;
+  arena_storage(arena_storage&&) = delete;
+  arena_storage& operator=(arena_storage&&) = delete;
+  arena_storage& operator=(arena_storage const&) = delete;
+
+  // Returns the arena shared by the storages with the same `Tag`.
+  static dyno::arena& shared_arena() {
+    static dyno::arena arena;
+    return arena;
+  }
+
+  template <typename T, typename RawT = std::decay_t<T>>
+  explicit arena_storage(T&& t)
+    : arena_storage{std::in_place_type<RawT>, std::forward<T>(t)}
+  { }
+
+  template <typename T, typename ...Args>
+  explicit arena_storage(std::in_place_type_t<T>, Args&& ...args) {
+    static_assert(dyno::is_trivially_relocatable<T>::value || std::is_nothrow_move_constructible<T>::value,
+      "dyno::arena_storage: The objects held in an arena_storage must be trivially "
+      "relocatable or have a move constructor that does not throw, since they are "
+      "relocated when the arena is compacted, which must not fail half-way.");
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+      "dyno::arena_storage: Over-aligned types are not supported yet.");
+    ptr_ = shared_arena().allocate(sizeof(T), arena_storage::relocator<T>(), &ptr_);
+    struct deallocate_on_exit {
+      void* ptr;
+      ~deallocate_on_exit() { if (ptr != nullptr) shared_arena().deallocate(ptr); }
+    } guard{ptr_};
+    detail::construct_at<T>(ptr_, std::forward<Args>(args)...);
+    guard.ptr = nullptr;
+  }
+
+  template <typename VTable>
+  arena_storage(arena_storage const& other, VTable const& vtable) {
+    // If the other storage was moved from, there is nothing to copy.
+    if (other.ptr_ == nullptr) {
+      ptr_ = nullptr;
+      return;
+    }
+    ptr_ = shared_arena().allocate(arena::size_of(other.ptr_), arena::relocator_of(other.ptr_), &ptr_);
+    struct deallocate_on_exit {
+      void* ptr;
+      ~deallocate_on_exit() { if (ptr != nullptr) shared_arena().deallocate(ptr); }
+    } guard{ptr_};
+    vtable["copy-construct"_s](ptr_, other.ptr_);
+    guard.ptr = nullptr;
+  }
+
+  template <typename VTable>
+  arena_storage(arena_storage&& other, VTable const&) noexcept
+    : ptr_{other.ptr_}
+  {
+    other.ptr_ = nullptr;
+    if (ptr_ != nullptr)
+      arena::set_owner(ptr_, &ptr_);
+  }
+
+  template <typename MyVTable, typename OtherVTable>
+  void swap(MyVTable const&, arena_storage& other, OtherVTable const&) {
+    std::swap(this->ptr_, other.ptr_);
+    if (this->ptr_ != nullptr)
+      arena::set_owner(this->ptr_, &this->ptr_);
+    if (other.ptr_ != nullptr)
+      arena::set_owner(other.ptr_, &other.ptr_);
+  }
+
+  template <typename VTable>
+  void destruct(VTable const& vtable) {
+    // If we've been moved from, don't do anything.
+    if (ptr_ == nullptr)
+      return;
+
+    vtable["destruct"_s](ptr_);
+    shared_arena().deallocate(ptr_);
+  }
+
+  template <typename T = void>
+  T* get() {
+    return static_cast<T*>(ptr_);
+  }
+
+  template <typename T = void>
+  T const* get() const {
+    return static_cast<T const*>(ptr_);
+  }
+
+  static constexpr bool can_store(dyno::storage_info info) {
+    return info.alignment <= alignof(std::max_align_t);
+  }
+
+private:
+  template <typename T>
+  static arena::relocate_function relocator() {
+    if constexpr (dyno::is_trivially_relocatable<T>::value) {
+      return nullptr;
+    } else {
+      return [](void* to, void* from) noexcept {
+        T* object = static_cast<T*>(from);
+        new (to) T(std::move(*object));
+        object->~T();
+      };
+    }
+  }
+
+  void* ptr_;
+};
+
+} // end namespace dyno
+
+#endif // DYNO_ARENA_HPP
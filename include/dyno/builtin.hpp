@@ -8,13 +8,26 @@
 #include <dyno/concept.hpp>
 #include <dyno/concept_map.hpp>
 
+#include <atomic>
 #include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <type_traits>
 #include <typeinfo>
+#include <utility>
 
 
 namespace dyno {
 
+// Whether objects of type `T` can be relocated, i.e. moved to another address
+// and destroyed at their original address, by simply copying their bytes.
+// This is the case for trivially copyable types, and this can be specialized
+// for other types, such as types holding a pointer to memory they own.
+template <typename T, typename = void>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> { };
+
 // Encapsulates the minimal amount of information required to allocate
 // storage for an object of a given type.
 //
@@ -22,18 +35,58 @@ namespace dyno {
 struct storage_info {
   std::size_t size;
   std::size_t alignment;
+  // Whether objects of the type can be move-constructed without throwing.
+  // Storages with non-throwing move operations use this to decide whether
+  // an object may be stored in a way that requires moving the object itself.
+  bool nothrow_movable;
+  // Whether objects of the type can be copy-constructed without throwing.
+  // `dyno::poly` uses this to decide whether a copy can be constructed in
+  // place of the object it holds, which must not fail half-way.
+  bool nothrow_copy_constructible;
+  // Whether objects of the type can be relocated by copying their bytes (see
+  // `dyno::is_trivially_relocatable`). Containers that move objects around
+  // use this to avoid calling the move constructor and the destructor.
+  bool trivially_relocatable;
+  // Whether destructing objects of the type does nothing. Storages deferring
+  // the destruction of objects use this to destroy those objects right away.
+  bool trivially_destructible;
 };
 
 template <typename T>
-constexpr auto storage_info_for = storage_info{sizeof(T), alignof(T)};
+constexpr auto storage_info_for = storage_info{
+  sizeof(T), alignof(T), std::is_nothrow_move_constructible<T>::value,
+  std::is_nothrow_copy_constructible<T>::value,
+  dyno::is_trivially_relocatable<T>::value,
+  std::is_trivially_destructible<T>::value
+};
 
+// The storage information is a constant, so storages can read it from the
+// vtable without making an indirect call.
+//
+// Note that `"storage_info"` used to be a function returning the information,
+// and constants can't be defined by functions in concept maps. Concept maps
+// defining it with a nullary function, like
+// ```
+// "storage_info"_s = []() { return dyno::storage_info_for<T>; }
+// ```
+// must now define it with `dyno::storage_info_constant` instead:
+// ```
+// "storage_info"_s = dyno::storage_info_constant<T>{}
+// ```
 struct Storable : decltype(dyno::requires(
-  "storage_info"_s = dyno::function<dyno::storage_info()>
+  "storage_info"_s = dyno::constant<dyno::storage_info>
 )) { };
 
+// Value of the `"storage_info"` constant for objects of type `T`, to be used
+// in concept maps.
+template <typename T>
+struct storage_info_constant {
+  static constexpr dyno::storage_info value = dyno::storage_info_for<T>;
+};
+
 template <typename T>
 auto const default_concept_map<Storable, T> = dyno::make_concept_map(
-  "storage_info"_s = []() { return dyno::storage_info_for<T>; }
+  "storage_info"_s = dyno::storage_info_constant<T>{}
 );
 
 
@@ -47,6 +100,80 @@ auto const default_concept_map<TypeId, T> = dyno::make_concept_map(
 );
 
 
+// Slot holding a small integer uniquely identifying a type in the program.
+//
+// Indices are handed out densely, starting at 0, in the order in which types
+// first request one (see `dyno::type_index_for`). The slot of each type is
+// initialized at compile-time, so its address can be stored in a vtable as a
+// constant, and reading the index of the type held by a `poly` only requires
+// loading it from the slot instead of making an indirect call.
+class type_index_slot {
+public:
+  // Value returned by `load()` when no index was assigned to the type yet.
+  static constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+  constexpr type_index_slot() : index_{none} { }
+  type_index_slot(type_index_slot const&) = delete;
+  type_index_slot& operator=(type_index_slot const&) = delete;
+
+  std::size_t load() const {
+    return index_.load(std::memory_order_acquire);
+  }
+
+  // Returns the index of the type, assigning the next one if needed.
+  std::size_t get() {
+    std::size_t index = this->load();
+    return index != none ? index : this->assign();
+  }
+
+private:
+  std::size_t assign() {
+    static std::mutex mutex;
+    static std::size_t next = 0;
+    std::lock_guard<std::mutex> lock{mutex};
+    std::size_t index = index_.load(std::memory_order_relaxed);
+    if (index == none) {
+      index = next++;
+      index_.store(index, std::memory_order_release);
+    }
+    return index;
+  }
+
+  std::atomic<std::size_t> index_;
+};
+
+namespace detail {
+  template <typename T>
+  inline dyno::type_index_slot type_index_slot_of{};
+
+  template <typename T>
+  struct type_index_constant {
+    static constexpr dyno::type_index_slot const* value = &type_index_slot_of<T>;
+  };
+} // end namespace detail
+
+// Returns a small integer uniquely identifying the type `T` in the program.
+//
+// Unlike `typeid`, this makes it suitable for indexing into arrays, such as
+// the tables used by `dyno::dispatch_table`.
+template <typename T>
+std::size_t type_index_for() {
+  return detail::type_index_slot_of<T>.get();
+}
+
+// The slot of the type is a constant, so the index of the type held by a
+// `poly` is read without making an indirect call. It is `none` until
+// `dyno::type_index_for` was called for that type.
+struct TypeIndex : decltype(dyno::requires(
+  "type_index"_s = dyno::constant<dyno::type_index_slot const*>
+)) { };
+
+template <typename T>
+auto const default_concept_map<TypeIndex, T> = dyno::make_concept_map(
+  "type_index"_s = detail::type_index_constant<T>{}
+);
+
+
 struct DefaultConstructible : decltype(dyno::requires(
   "default-construct"_s = dyno::function<void (void*)>
 )) { };
@@ -90,21 +217,143 @@ auto const default_concept_map<CopyConstructible, T,
 );
 
 
+// When the concept of a `dyno::poly` includes `MoveAssignable`, `"move-assign"`
+// is used to move-assign a `poly` from a `poly` holding an object of the same
+// type, which allows reusing the resources held by the object being assigned.
+//
+// The entry is optional: it is a constant holding a pointer to the function,
+// which is null for types that are not move-assignable (e.g. lambdas with
+// captures). Such types still model the concept, and a `poly` holding them
+// is assigned by constructing a new object, like when the types differ.
 struct MoveAssignable : decltype(dyno::requires(
-  // No virtual function required to support this so far
+  "move-assign"_s = dyno::constant<void (*)(void*, void*)>
 )) { };
 
+namespace detail {
+  template <typename T, bool = std::is_move_assignable<T>::value>
+  struct move_assign_constant {
+    static void apply(void* self, void* other) {
+      *static_cast<T*>(self) = std::move(*static_cast<T*>(other));
+    }
+    static constexpr void (*value)(void*, void*) = &apply;
+  };
+
+  template <typename T>
+  struct move_assign_constant<T, false> {
+    static constexpr void (*value)(void*, void*) = nullptr;
+  };
+} // end namespace detail
+
+template <typename T>
+auto const default_concept_map<MoveAssignable, T> = dyno::make_concept_map(
+  "move-assign"_s = detail::move_assign_constant<T>{}
+);
+
 
+// Like `MoveAssignable`, `"copy-assign"` is used to copy-assign a `dyno::poly`
+// from a `poly` holding an object of the same type, and it is null for types
+// that are not copy-assignable.
 struct CopyAssignable : decltype(dyno::requires(
-  dyno::MoveAssignable{}
-  // No additional virtual functions required to support this so far
+  dyno::MoveAssignable{},
+  "copy-assign"_s = dyno::constant<void (*)(void*, void const*)>
 )) { };
 
+namespace detail {
+  template <typename T, bool = std::is_copy_assignable<T>::value>
+  struct copy_assign_constant {
+    static void apply(void* self, void const* other) {
+      *static_cast<T*>(self) = *static_cast<T const*>(other);
+    }
+    static constexpr void (*value)(void*, void const*) = &apply;
+  };
+
+  template <typename T>
+  struct copy_assign_constant<T, false> {
+    static constexpr void (*value)(void*, void const*) = nullptr;
+  };
+} // end namespace detail
 
+template <typename T>
+auto const default_concept_map<CopyAssignable, T> = dyno::make_concept_map(
+  "copy-assign"_s = detail::copy_assign_constant<T>{}
+);
+
+
+// When the concept of a `dyno::poly` includes `Swappable`, `"swap"` is used by
+// storages holding objects in a local buffer to swap objects of the same type,
+// instead of moving them through a temporary. Like for `MoveAssignable`, the
+// entry is a pointer to the function, which is null for types that are not
+// swappable, so that any type models the concept.
 struct Swappable : decltype(dyno::requires(
-  // No virtual functions required to support this so far
+  "swap"_s = dyno::constant<void (*)(void*, void*)>
+)) { };
+
+namespace detail {
+  template <typename T, bool = std::is_swappable<T>::value>
+  struct swap_constant {
+    static void apply(void* a, void* b) {
+      using std::swap;
+      swap(*static_cast<T*>(a), *static_cast<T*>(b));
+    }
+    static constexpr void (*value)(void*, void*) = &apply;
+  };
+
+  template <typename T>
+  struct swap_constant<T, false> {
+    static constexpr void (*value)(void*, void*) = nullptr;
+  };
+} // end namespace detail
+
+template <typename T>
+auto const default_concept_map<Swappable, T> = dyno::make_concept_map(
+  "swap"_s = detail::swap_constant<T>{}
+);
+
+
+// When the concept of a `dyno::poly` includes `Clonable`, storages holding
+// objects on the heap use `"clone"` to allocate a copy of an object and to
+// construct it in a single call. The memory must be allocated with
+// `std::malloc`, since storages may free it with `std::free`.
+struct Clonable : decltype(dyno::requires(
+  "clone"_s = dyno::function<void* (dyno::T const&)>
+)) { };
+
+template <typename T>
+auto const default_concept_map<Clonable, T,
+  std::enable_if_t<std::is_copy_constructible<T>::value>
+> = dyno::make_concept_map(
+  "clone"_s = [](T const& other) -> void* {
+    struct free_on_exit {
+      void* ptr;
+      ~free_on_exit() { std::free(ptr); }
+    } guard{std::malloc(sizeof(T))};
+    if (guard.ptr == nullptr)
+      throw std::bad_alloc{};
+    void* ptr = new (guard.ptr) T(other);
+    guard.ptr = nullptr;
+    return ptr;
+  }
+);
+
+
+// Like `Clonable`, `"destroy"` is used by storages holding objects on the heap
+// to destruct an object and to free its memory in a single call. The object
+// may have been allocated by a storage with `std::malloc`, so it must be freed
+// with `std::free`.
+struct Destroyable : decltype(dyno::requires(
+  "destroy"_s = dyno::function<void (dyno::T&)>
 )) { };
 
+template <typename T>
+auto const default_concept_map<Destroyable, T,
+  std::enable_if_t<std::is_destructible<T>::value>
+> = dyno::make_concept_map(
+  "destroy"_s = [](T& self) {
+    self.~T();
+    std::free(std::addressof(self));
+  }
+);
+
 
 struct EqualityComparable : decltype(dyno::requires(
   "equal"_s = dyno::function<bool (dyno::T const&, dyno::T const&)>
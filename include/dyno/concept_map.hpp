@@ -9,6 +9,7 @@
 #include <dyno/detail/bind_signature.hpp>
 #include <dyno/detail/dsl.hpp>
 #include <dyno/detail/empty_object.hpp>
+#include <dyno/detail/forward_param.hpp>
 #include <dyno/detail/has_duplicates.hpp>
 
 #include <boost/hana/at_key.hpp>
@@ -25,6 +26,7 @@
 #include <boost/hana/union.hpp>
 #include <boost/hana/unpack.hpp>
 
+#include <cstddef>
 #include <type_traits>
 #include <utility>
 
@@ -35,24 +37,134 @@ namespace detail {
   // We wrap all lambdas and function objects passed to the library using this
   // hack, so that we can pretend stateless lambdas are default constructible
   // in the rest of the library.
+  //
+  // When the signature is `noexcept`, the function object must be callable
+  // without throwing, which is checked when the function is used. Parameters
+  // are passed through as explained in `forward_param`, so that arguments are
+  // not copied or moved on their way to the function object.
   template <typename F, typename Signature>
   struct default_constructible_lambda;
 
-  template <typename F, typename R, typename ...Args>
-  struct default_constructible_lambda<F, R(Args...)> {
-    constexpr R operator()(Args ...args) const {
+  template <typename F, typename R, typename ...Args, bool NoExcept>
+  struct default_constructible_lambda<F, R(Args...) noexcept(NoExcept)> {
+    constexpr R operator()(typename detail::forward_param<Args>::type ...args) const noexcept(NoExcept) {
       auto lambda = detail::empty_object<F>::get();
-      return lambda(std::forward<Args>(args)...);
+      static_assert(!NoExcept || noexcept(lambda(std::forward<typename detail::forward_param<Args>::type>(args)...)),
+        "dyno::concept_map: The function provided in a concept map for a "
+        "function declared `noexcept` in the concept is not `noexcept`. "
+        "Make sure to mark the function as `noexcept` in the concept map.");
+      return lambda(std::forward<typename detail::forward_param<Args>::type>(args)...);
     }
   };
 
-  template <typename F, typename ...Args>
-  struct default_constructible_lambda<F, void(Args...)> {
-    constexpr void operator()(Args ...args) const {
+  template <typename F, typename ...Args, bool NoExcept>
+  struct default_constructible_lambda<F, void(Args...) noexcept(NoExcept)> {
+    constexpr void operator()(typename detail::forward_param<Args>::type ...args) const noexcept(NoExcept) {
       auto lambda = detail::empty_object<F>::get();
-      lambda(std::forward<Args>(args)...);
+      static_assert(!NoExcept || noexcept(lambda(std::forward<typename detail::forward_param<Args>::type>(args)...)),
+        "dyno::concept_map: The function provided in a concept map for a "
+        "function declared `noexcept` in the concept is not `noexcept`. "
+        "Make sure to mark the function as `noexcept` in the concept map.");
+      lambda(std::forward<typename detail::forward_param<Args>::type>(args)...);
     }
   };
+
+  // Returns the type stored in a concept map for the given clause. Functions
+  // are wrapped as explained above, while constants are stored as-is, since
+  // their value is carried by their type.
+  template <typename Clause, typename T, typename Function>
+  struct concept_map_entry {
+    using type = detail::default_constructible_lambda<
+      Function,
+      typename detail::bind_signature<typename Clause::type, T>::type
+    >;
+  };
+
+  // Batch function defined in a concept map by a function taking a single
+  // object, which is called on each object of the array in turn.
+  template <typename F, typename BatchSignature>
+  struct batch_loop;
+
+  template <typename F, typename Object, typename ...Args, bool NoExcept>
+  struct batch_loop<F, void(Object*, std::size_t, Args...) noexcept(NoExcept)> {
+    constexpr void operator()(Object* first, std::size_t size,
+                              typename detail::forward_param<Args>::type ...args) const noexcept(NoExcept)
+    {
+      auto lambda = detail::empty_object<F>::get();
+      static_assert(!NoExcept || noexcept(lambda(*first, args...)),
+        "dyno::concept_map: The function provided in a concept map for a "
+        "function declared `noexcept` in the concept is not `noexcept`. "
+        "Make sure to mark the function as `noexcept` in the concept map.");
+      for (Object* object = first; object != first + size; ++object)
+        lambda(*object, args...);
+    }
+  };
+
+  // Whether `F` can be called with the array itself, or with each object of
+  // the array, when used for a batch function with the given signature.
+  template <typename F, typename BatchSignature>
+  struct batch_callable;
+
+  template <typename F, typename Object, typename ...Args, bool NoExcept>
+  struct batch_callable<F, void(Object*, std::size_t, Args...) noexcept(NoExcept)> {
+    static constexpr bool with_array = std::is_invocable<F const&, Object*, std::size_t, Args&...>::value;
+    static constexpr bool with_object = std::is_invocable<F const&, Object&, Args&...>::value;
+  };
+
+  // A batch function is given in a concept map either as a function taking the
+  // whole array, or as a function taking a single object (see `batch_function`).
+  template <typename Signature, typename T, typename Function>
+  struct concept_map_entry<dyno::batch_function_t<Signature>, T, Function> {
+    using Batch = typename detail::bind_signature<Signature, T>::type;
+    using Callable = detail::batch_callable<Function, Batch>;
+    static_assert(Callable::with_array || Callable::with_object,
+      "dyno::concept_map: The function provided in a concept map for a batch "
+      "function must take either a pointer to the first object and the number "
+      "of objects, or a single object, followed by the other arguments.");
+
+    using type = std::conditional_t<Callable::with_array,
+      detail::default_constructible_lambda<Function, Batch>,
+      detail::batch_loop<Function, Batch>
+    >;
+  };
+
+  template <typename Value, typename Type, typename = void>
+  struct is_constant_value : std::false_type { };
+
+  template <typename Value, typename Type>
+  struct is_constant_value<Value, Type, std::enable_if_t<
+    std::is_convertible<decltype(Value::value), Type>::value
+  >> : std::true_type { };
+
+  template <typename Type, typename T, typename Value>
+  struct concept_map_entry<dyno::constant_t<Type>, T, Value> {
+    static_assert(detail::is_constant_value<Value, Type>::value || std::is_invocable<Value const&>::value,
+      "dyno::concept_map: The value provided in a concept map for a constant "
+      "must be an object whose type has a static `value` member convertible to "
+      "the type of the constant, like `std::integral_constant`.");
+    static_assert(detail::is_constant_value<Value, Type>::value || !std::is_invocable<Value const&>::value,
+      "dyno::concept_map: The value provided in a concept map for a constant "
+      "can't be a function, since the value must be known at compile-time. "
+      "Use an object whose type has a static `value` member instead, like "
+      "`std::integral_constant`. For `\"storage_info\"`, which used to be a "
+      "function, use `dyno::storage_info_constant<T>{}`.");
+    using type = Value;
+  };
+
+  template <typename Value, typename Type>
+  struct is_field_offset : std::false_type { };
+
+  template <typename Type, std::size_t Offset>
+  struct is_field_offset<dyno::field_offset<Type, Offset>, Type> : std::true_type { };
+
+  template <typename Type, typename T, typename Value>
+  struct concept_map_entry<dyno::field_t<Type>, T, Value> {
+    static_assert(detail::is_field_offset<Value, Type>::value,
+      "dyno::concept_map: The value provided in a concept map for a field must "
+      "be created with `DYNO_FIELD(Class, member)`, and the member must have the "
+      "same type as the field.");
+    using type = Value;
+  };
 } // end namespace detail
 
 // A concept map is a statically-known mapping from functions implemented by
@@ -91,12 +203,9 @@ private:
   using as_hana_map = boost::hana::map<
     boost::hana::pair<
       Name,
-      detail::default_constructible_lambda<
-        Function,
-        typename detail::bind_signature<
-          typename decltype(Concept{}.get_signature(Name{}))::type, T
-        >::type
-      >
+      typename detail::concept_map_entry<
+        decltype(Concept{}.get_signature(Name{})), T, Function
+      >::type
     >...
   >;
 };
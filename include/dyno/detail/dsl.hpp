@@ -12,6 +12,7 @@
 #include <boost/hana/tuple.hpp>
 #include <boost/hana/type.hpp>
 
+#include <cstddef>
 #include <type_traits>
 #include <utility>
 
@@ -32,7 +33,8 @@ constexpr auto operator!=(function_t<Sig1> m1, function_t<Sig2> m2) {
 }
 
 // Right-hand-side of a clause in a concept that signifies a function with the
-// given signature.
+// given signature. The signature may be `noexcept`, in which case the function
+// provided in concept maps must be `noexcept` too.
 template <typename Signature>
 constexpr function_t<Signature> function{};
 
@@ -42,6 +44,7 @@ struct method_t;
 // Right-hand-side of a clause in a concept that signifies a method with the
 // given signature. The first parameter of the resulting function is implicitly
 // `dyno::T&` for a non-const method, and `dyno::T const&` for a const method.
+// Like for `dyno::function`, the signature may be `noexcept`.
 template <typename Signature>
 constexpr method_t<Signature> method{};
 
@@ -49,17 +52,17 @@ constexpr method_t<Signature> method{};
 // defining a clause in a concept.
 struct T;
 
-template <typename R, typename ...Args>
-struct method_t<R(Args...)> { using type = R (dyno::T&, Args...); };
-template <typename R, typename ...Args>
-struct method_t<R(Args...) &> { using type = R (dyno::T&, Args...); };
-template <typename R, typename ...Args>
-struct method_t<R(Args...) &&> { using type = R (dyno::T&&, Args...); };
-
-template <typename R, typename ...Args>
-struct method_t<R(Args...) const> { using type = R (dyno::T const&, Args...); };
-template <typename R, typename ...Args>
-struct method_t<R(Args...) const&> { using type = R (dyno::T const&, Args...); };
+template <typename R, typename ...Args, bool NoExcept>
+struct method_t<R(Args...) noexcept(NoExcept)> { using type = R (dyno::T&, Args...) noexcept(NoExcept); };
+template <typename R, typename ...Args, bool NoExcept>
+struct method_t<R(Args...) & noexcept(NoExcept)> { using type = R (dyno::T&, Args...) noexcept(NoExcept); };
+template <typename R, typename ...Args, bool NoExcept>
+struct method_t<R(Args...) && noexcept(NoExcept)> { using type = R (dyno::T&&, Args...) noexcept(NoExcept); };
+
+template <typename R, typename ...Args, bool NoExcept>
+struct method_t<R(Args...) const noexcept(NoExcept)> { using type = R (dyno::T const&, Args...) noexcept(NoExcept); };
+template <typename R, typename ...Args, bool NoExcept>
+struct method_t<R(Args...) const& noexcept(NoExcept)> { using type = R (dyno::T const&, Args...) noexcept(NoExcept); };
 // const&& not supported because it's stupid
 
 template <typename Sig1, typename Sig2>
@@ -72,6 +75,113 @@ constexpr auto operator!=(method_t<Sig1> m1, method_t<Sig2> m2) {
   return !(m1 == m2);
 }
 
+template <typename Signature>
+struct batch_function_t {
+  static_assert(!std::is_same<Signature, Signature>::value, // make the assertion dependent
+    "dyno::batch_function: The signature of a batch function must be of the "
+    "form `void (dyno::T*, std::size_t, Args...)` or `void (dyno::T const*, "
+    "std::size_t, Args...)`.");
+};
+
+template <typename ...Args, bool NoExcept>
+struct batch_function_t<void (dyno::T*, std::size_t, Args...) noexcept(NoExcept)> {
+  using type = void (dyno::T*, std::size_t, Args...) noexcept(NoExcept);
+};
+
+template <typename ...Args, bool NoExcept>
+struct batch_function_t<void (dyno::T const*, std::size_t, Args...) noexcept(NoExcept)> {
+  using type = void (dyno::T const*, std::size_t, Args...) noexcept(NoExcept);
+};
+
+// Right-hand-side of a clause in a concept that signifies a function applied
+// to a contiguous array of objects of the same type at once, given as a
+// pointer to the first object and the number of objects. This allows a type
+// to process many objects in a single call, for example with SIMD
+// instructions, instead of being called once per object.
+//
+// In a concept map, a batch function is defined either by a function taking
+// the array (`T*` and `std::size_t`) followed by the other arguments, or by
+// a function taking a single object (`T&`) followed by the other arguments,
+// in which case the batch function calls it on each object in turn. Either
+// way, the other arguments are passed as lvalues, since they are shared by
+// all the objects.
+//
+// Calling a batch function through a `dyno::poly` applies it to the single
+// object held by the `poly`. Containers holding objects of the same type next
+// to each other, like `dyno::poly_collection`, call it once per array instead.
+template <typename Signature>
+constexpr batch_function_t<Signature> batch_function{};
+
+template <typename Sig1, typename Sig2>
+constexpr auto operator==(batch_function_t<Sig1>, batch_function_t<Sig2>) {
+  return boost::hana::bool_c<std::is_same<Sig1, Sig2>::value>;
+}
+
+template <typename Sig1, typename Sig2>
+constexpr auto operator!=(batch_function_t<Sig1> b1, batch_function_t<Sig2> b2) {
+  return !(b1 == b2);
+}
+
+template <typename Type>
+struct constant_t { using type = Type; };
+
+// Right-hand-side of a clause in a concept that signifies a constant of the
+// given type, such as a tag or a property of the type. Unlike functions,
+// constants are stored directly in the vtable, so reading them does not
+// require an indirect call.
+//
+// In a concept map, a constant is defined by an empty object whose type has
+// a static `value` member convertible to `Type`, like `std::integral_constant`.
+// This makes sure that vtables can still be initialized at compile-time.
+template <typename Type>
+constexpr constant_t<Type> constant{};
+
+template <typename Type1, typename Type2>
+constexpr auto operator==(constant_t<Type1>, constant_t<Type2>) {
+  return boost::hana::bool_c<std::is_same<Type1, Type2>::value>;
+}
+
+template <typename Type1, typename Type2>
+constexpr auto operator!=(constant_t<Type1> c1, constant_t<Type2> c2) {
+  return !(c1 == c2);
+}
+
+template <typename Type>
+struct field_t { using type = Type; };
+
+// Right-hand-side of a clause in a concept that signifies a data member of
+// the given type. The offset of the member within the object is stored in
+// the vtable, so accessing the member does not require an indirect call.
+//
+// In a concept map, a field is defined using `DYNO_FIELD(Class, member)`,
+// which requires `offsetof` to be supported for `Class`, i.e. `Class` should
+// be a standard-layout type.
+template <typename Type>
+constexpr field_t<Type> field{};
+
+template <typename Type1, typename Type2>
+constexpr auto operator==(field_t<Type1>, field_t<Type2>) {
+  return boost::hana::bool_c<std::is_same<Type1, Type2>::value>;
+}
+
+template <typename Type1, typename Type2>
+constexpr auto operator!=(field_t<Type1> f1, field_t<Type2> f2) {
+  return !(f1 == f2);
+}
+
+// Value of a field in a concept map, which is the offset of a member of type
+// `Type` within its class. This should usually be created with `DYNO_FIELD`.
+template <typename Type, std::size_t Offset>
+struct field_offset {
+  using type = Type;
+  static constexpr std::size_t value = Offset;
+};
+
+// Creates the value of a `dyno::field` in a concept map, for the data member
+// `member` of the class `Class`.
+#define DYNO_FIELD(Class, member)                                           \
+  (::dyno::field_offset<decltype(Class::member), offsetof(Class, member)>{})
+
 namespace detail {
   template <typename Name, typename ...Args>
   struct delayed_call {
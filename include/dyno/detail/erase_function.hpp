@@ -6,10 +6,13 @@
 #define DYNO_DETAIL_ERASE_FUNCTION_HPP
 
 #include <dyno/detail/empty_object.hpp>
+#include <dyno/detail/erase_signature.hpp>
 #include <dyno/detail/eraser_traits.hpp>
 
 #include <boost/callable_traits/function_type.hpp>
 
+#include <new>
+#include <type_traits>
 #include <utility>
 
 
@@ -18,44 +21,71 @@ namespace dyno { namespace detail {
 template <typename Eraser, typename F, typename PlaceholderSig, typename ActualSig>
 struct thunk;
 
-template <typename Eraser, typename F, typename R_pl, typename ...Args_pl,
+template <typename Eraser, typename F, typename R_pl, typename ...Args_pl, bool NoExcept,
                                        typename R_ac, typename ...Args_ac>
-struct thunk<Eraser, F, R_pl(Args_pl...), R_ac(Args_ac...)> {
+struct thunk<Eraser, F, R_pl(Args_pl...) noexcept(NoExcept), R_ac(Args_ac...)> {
   static constexpr auto
-  apply(typename detail::erase_placeholder<Eraser, Args_pl>::type ...args)
+  apply(typename detail::erase_parameter<Eraser, Args_pl>::type ...args) noexcept(NoExcept)
     -> typename detail::erase_placeholder<Eraser, R_pl>::type
   {
     return detail::erase<Eraser, R_pl>::apply(
       detail::empty_object<F>::get()(
         detail::unerase<Eraser, Args_pl, Args_ac>::apply(
-          std::forward<typename detail::erase_placeholder<Eraser, Args_pl>::type>(args)
+          std::forward<typename detail::erase_parameter<Eraser, Args_pl>::type>(args)
         )...
       )
     );
   }
 };
 
-template <typename Eraser, typename F,    /* void */  typename ...Args_pl,
+template <typename Eraser, typename F,    /* void */  typename ...Args_pl, bool NoExcept,
                                        typename R_ac, typename ...Args_ac>
-struct thunk<Eraser, F, void(Args_pl...), R_ac(Args_ac...)> {
+struct thunk<Eraser, F, void(Args_pl...) noexcept(NoExcept), R_ac(Args_ac...)> {
   static constexpr auto
-  apply(typename detail::erase_placeholder<Eraser, Args_pl>::type ...args)
+  apply(typename detail::erase_parameter<Eraser, Args_pl>::type ...args) noexcept(NoExcept)
     -> void
   {
     detail::empty_object<F>::get()(
       detail::unerase<Eraser, Args_pl, Args_ac>::apply(
-        std::forward<typename detail::erase_placeholder<Eraser, Args_pl>::type>(args)
+        std::forward<typename detail::erase_parameter<Eraser, Args_pl>::type>(args)
       )...
     );
   }
 };
 
+// A placeholder returned by value is constructed directly at the address given
+// as the first parameter, see `erase_signature`. Since the function returns a
+// prvalue of the actual type, no temporary is created.
+template <typename Eraser, typename F,  /* dyno::T */ typename ...Args_pl, bool NoExcept,
+                                       typename R_ac, typename ...Args_ac>
+struct thunk<Eraser, F, dyno::T(Args_pl...) noexcept(NoExcept), R_ac(Args_ac...)> {
+  static_assert(std::is_object<R_ac>::value,
+    "dyno::erase_function: A function returning `dyno::T` by value must return "
+    "an object by value.");
+
+  static constexpr auto
+  apply(typename detail::erase_placeholder<Eraser, dyno::T*>::type result,
+        typename detail::erase_parameter<Eraser, Args_pl>::type ...args) noexcept(NoExcept)
+    -> void
+  {
+    new (detail::unerase<Eraser, dyno::T*, R_ac*>::apply(result)) R_ac(
+      detail::empty_object<F>::get()(
+        detail::unerase<Eraser, Args_pl, Args_ac>::apply(
+          std::forward<typename detail::erase_parameter<Eraser, Args_pl>::type>(args)
+        )...
+      )
+    );
+  }
+};
+
 // Transform an actual (stateless) function object with statically typed
 // parameters into a type-erased function suitable for storage in a vtable.
 //
 // The pointer returned by `erase_function` is what's called a thunk; it
 // makes a few adjustments to the arguments (usually 0-overhead static
-// casts) and forwards them to another function.
+// casts) and forwards them to another function. If `Signature` is `noexcept`,
+// so is the thunk. The parameters of the thunk are the parameters of the
+// signature returned by `erase_signature`.
 //
 // TODO:
 //  - Would it be possible to erase a callable that's not a stateless function
@@ -6,16 +6,18 @@
 #define DYNO_DETAIL_ERASE_SIGNATURE_HPP
 
 #include <dyno/detail/eraser_traits.hpp>
-#include <dyno/detail/transform_signature.hpp>
+#include <dyno/detail/forward_param.hpp>
 
 
 namespace dyno { namespace detail {
 
-template <typename Eraser>
-struct apply_erase_placeholder {
-  template <typename Placeholder>
-  using apply = detail::erase_placeholder<Eraser, Placeholder>;
-};
+// Returns the type used to pass a parameter declared with the given type to
+// an erased function. Placeholders are erased, and parameters taken by value
+// are passed as explained in `forward_param`.
+template <typename Eraser, typename Param>
+struct erase_parameter
+  : detail::forward_param<typename detail::erase_placeholder<Eraser, Param>::type>
+{ };
 
 // Transforms a signature potentially containing placeholders into a signature
 // containing no placeholders, and which would be suitable for storing as a
@@ -26,15 +28,43 @@ struct apply_erase_placeholder {
 // we need to generate a vtable from a concept definition. The concept defines
 // signatures with placeholders, and we need to generate a concrete function
 // type that can be stored in a vtable. That concrete type is the result of
-// `erase_signature`.
+// `erase_signature`. Parameters taken by value that are expensive to copy
+// are taken by rvalue reference in the resulting signature.
+//
+// A placeholder returned by value can't be returned from the erased function,
+// since its size is not known to the caller. Instead, the erased function
+// takes the address where the result must be constructed as an additional
+// first parameter (erased like a `dyno::T*`), and it returns `void`.
 //
 // Note that this returns a function type, not a function pointer type.
 // For actually storing an object of this type, one needs to add a pointer
 // qualifier to it.
 template <typename Signature, typename Eraser = void>
-using erase_signature = detail::transform_signature<
-  Signature, detail::apply_erase_placeholder<Eraser>::template apply
->;
+struct erase_signature;
+
+template <typename R, typename ...Args, bool NoExcept, typename Eraser>
+struct erase_signature<R (Args...) noexcept(NoExcept), Eraser> {
+  using type = typename detail::erase_placeholder<Eraser, R>::type
+               (typename detail::erase_parameter<Eraser, Args>::type...) noexcept(NoExcept);
+};
+
+template <typename R, typename ...Args, bool NoExcept, typename Eraser>
+struct erase_signature<R (Args..., ...) noexcept(NoExcept), Eraser> {
+  using type = typename detail::erase_placeholder<Eraser, R>::type
+               (typename detail::erase_parameter<Eraser, Args>::type..., ...) noexcept(NoExcept);
+};
+
+template <typename ...Args, bool NoExcept, typename Eraser>
+struct erase_signature<dyno::T (Args...) noexcept(NoExcept), Eraser> {
+  using type = void (typename detail::erase_placeholder<Eraser, dyno::T*>::type,
+                     typename detail::erase_parameter<Eraser, Args>::type...) noexcept(NoExcept);
+};
+
+template <typename ...Args, bool NoExcept, typename Eraser>
+struct erase_signature<dyno::T (Args..., ...) noexcept(NoExcept), Eraser> {
+  using type = void (typename detail::erase_placeholder<Eraser, dyno::T*>::type,
+                     typename detail::erase_parameter<Eraser, Args>::type..., ...) noexcept(NoExcept);
+};
 
 }} // end namespace dyno::detail
 
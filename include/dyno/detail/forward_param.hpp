@@ -0,0 +1,67 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#ifndef DYNO_DETAIL_FORWARD_PARAM_HPP
+#define DYNO_DETAIL_FORWARD_PARAM_HPP
+
+#include <type_traits>
+
+
+namespace dyno { namespace detail {
+
+// Metafunction returning the type used to pass a parameter declared with
+// type `T` through the layers between the caller of a type-erased function
+// and the function provided in the concept map (the thunk, the wrapper
+// around the function in the concept map, etc).
+//
+// Parameters taken by value are passed by rvalue reference instead, unless
+// they are cheap to copy. That way, the argument is not copied or moved once
+// per layer; it is only materialized by the caller when it is not already an
+// rvalue of type `T` (see `forward_arg`), and by the function in the concept
+// map if that function takes its parameter by value.
+template <typename T, bool = std::is_object<T>::value &&
+                             !(std::is_trivially_copyable<T>::value &&
+                               sizeof(T) <= 2 * sizeof(void*))>
+struct forward_param { using type = T; };
+
+template <typename T>
+struct forward_param<T, true> { using type = T&&; };
+
+template <typename T>
+T implicit_convert(T) noexcept;
+
+template <typename T, typename Arg>
+constexpr T convert_arg(Arg&& arg)
+  noexcept(noexcept(detail::implicit_convert<T>(static_cast<Arg&&>(arg))))
+{ return static_cast<Arg&&>(arg); }
+
+// Returns whether an argument of type `Arg&&` must be converted to a temporary
+// of type `T` before being passed to a parameter declared with type `T`.
+template <typename T, typename Arg>
+constexpr bool needs_temporary =
+  !std::is_reference<T>::value &&
+  std::is_same<typename detail::forward_param<T>::type, T&&>::value &&
+  !std::is_same<Arg&&, T&&>::value;
+
+// Prepares an argument for being passed to a parameter declared with type
+// `T`, which is passed as `forward_param<T>::type`.
+//
+// If the parameter is passed by rvalue reference but the argument is not an
+// rvalue of type `T`, a temporary is created by implicitly converting the
+// argument to `T`, exactly like when passing it to a parameter of type `T`.
+// Otherwise, the argument is passed through.
+template <typename T, typename Arg>
+constexpr decltype(auto) forward_arg(Arg&& arg)
+  noexcept(!detail::needs_temporary<T, Arg> ||
+           noexcept(detail::implicit_convert<T>(static_cast<Arg&&>(arg))))
+{
+  if constexpr (detail::needs_temporary<T, Arg>)
+    return detail::convert_arg<T>(static_cast<Arg&&>(arg));
+  else
+    return static_cast<Arg&&>(arg);
+}
+
+}} // end namespace dyno::detail
+
+#endif // DYNO_DETAIL_FORWARD_PARAM_HPP
@@ -0,0 +1,120 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#ifndef DYNO_DETAIL_POLY_ACCESS_HPP
+#define DYNO_DETAIL_POLY_ACCESS_HPP
+
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/vtable.hpp>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+
+namespace dyno { namespace detail {
+
+// Hints the processor to load the cache line holding the given address, if
+// the compiler supports it.
+inline void prefetch(void const* address) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(address);
+#else
+  (void)address;
+#endif
+}
+
+template <typename Clause>
+struct is_batch_function : std::false_type { };
+
+template <typename Signature>
+struct is_batch_function<dyno::batch_function_t<Signature>> : std::true_type { };
+
+// Gives access to the internals of `dyno::poly` to the algorithms and the
+// containers operating on many `poly`s (or many objects) at once.
+struct poly_access {
+  // The type of the vtable of a `Poly`.
+  template <typename Poly>
+  struct vtable_of { using type = typename Poly::VTable; };
+
+  template <typename Poly>
+  using vtable_t = typename vtable_of<Poly>::type;
+
+  // Whether objects of type `T` can be held in a `Poly`.
+  template <typename Poly, typename T>
+  static constexpr bool models = dyno::models<typename Poly::ActualConcept, T>;
+
+  // Whether the function with the given name is a `dyno::batch_function` in
+  // the concept of a `Poly`.
+  template <typename Poly, typename Function>
+  static constexpr bool is_batch = detail::is_batch_function<
+    decltype(typename Poly::ActualConcept{}.get_signature(Function{}))
+  >::value;
+
+  // Returns the vtable that a `Poly` holding an object of type `T` would use.
+  template <typename Poly, typename T>
+  static vtable_t<Poly> vtable_for() {
+    using ActualConcept = typename Poly::ActualConcept;
+    return vtable_t<Poly>{dyno::complete_concept_map<ActualConcept, T>(
+      dyno::concept_map<ActualConcept, T>
+    )};
+  }
+
+  // Returns a `Poly` (with a non-owning storage) referencing the object at
+  // the given address, using the given vtable for it.
+  template <typename Poly, typename Pointer>
+  static Poly reference(vtable_t<Poly> const& vtable, Pointer object) {
+    object_pointer<Pointer> pointer{object};
+    return Poly{detail::reference_object, vtable, pointer};
+  }
+
+  template <typename Poly, typename Function>
+  static auto lookup(Poly const& poly, Function name) {
+    return poly.vtable_[name];
+  }
+
+  template <typename Poly, typename Function, typename FunctionPtr>
+  static auto bind(Poly& poly, Function name, FunctionPtr fptr) {
+    return poly.bind_resolved(name, fptr);
+  }
+
+  // Binds a batch function to the array of `size` objects starting with the
+  // object referenced by `poly`.
+  template <typename Poly, typename Function, typename FunctionPtr>
+  static auto bind_batch(Poly& poly, Function name, FunctionPtr fptr, std::size_t size) {
+    return poly.bind_resolved_batch(name, fptr, size);
+  }
+
+  template <typename Poly>
+  static void const* concept_map_id(Poly const& poly) {
+    static_assert(detail::has_concept_map_id<vtable_t<Poly>>::value,
+      "dyno::partition_by_type: The vtable of the polys can't identify the "
+      "concept map it was created from, so the polys can't be grouped by type. "
+      "Use a vtable policy that stores at least some functions remotely.");
+    return poly.vtable_.concept_map_id();
+  }
+
+  // Prefetches the object held by the `poly` and, when it is stored remotely,
+  // its vtable, whose address is then the identifier of the concept map.
+  template <typename Poly>
+  static void prefetch(Poly const& poly) {
+    detail::prefetch(poly.storage_.get());
+    if constexpr (detail::has_concept_map_id<vtable_t<Poly>>::value)
+      detail::prefetch(poly.vtable_.concept_map_id());
+  }
+
+private:
+  // Looks like a polymorphic storage holding the object at the given address,
+  // so that non-owning storages can reference that object.
+  template <typename Pointer>
+  struct object_pointer {
+    Pointer ptr;
+    Pointer get() const { return ptr; }
+  };
+};
+
+}} // end namespace dyno::detail
+
+#endif // DYNO_DETAIL_POLY_ACCESS_HPP
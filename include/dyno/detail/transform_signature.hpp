@@ -9,20 +9,21 @@ namespace dyno { namespace detail {
 
 // Transforms a signature by applying a metafunction to the return type and
 // all the arguments of a function signature. This returns a function type,
-// not a pointer to a function.
+// not a pointer to a function. The resulting signature is `noexcept` if and
+// only if the original signature is.
 template <typename Signature, template <typename ...> class F>
 struct transform_signature;
 
-template <typename R, typename ...Args, template <typename ...> class F>
-struct transform_signature<R (Args...), F> {
+template <typename R, typename ...Args, bool NoExcept, template <typename ...> class F>
+struct transform_signature<R (Args...) noexcept(NoExcept), F> {
   using Result = typename F<R>::type;
-  using type = Result (typename F<Args>::type...);
+  using type = Result (typename F<Args>::type...) noexcept(NoExcept);
 };
 
-template <typename R, typename ...Args, template <typename ...> class F>
-struct transform_signature<R (Args..., ...), F> {
+template <typename R, typename ...Args, bool NoExcept, template <typename ...> class F>
+struct transform_signature<R (Args..., ...) noexcept(NoExcept), F> {
   using Result = typename F<R>::type;
-  using type = Result (typename F<Args>::type..., ...);
+  using type = Result (typename F<Args>::type..., ...) noexcept(NoExcept);
 };
 
 }} // end namespace dyno::detail
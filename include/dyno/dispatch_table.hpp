@@ -0,0 +1,165 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#ifndef DYNO_DISPATCH_TABLE_HPP
+#define DYNO_DISPATCH_TABLE_HPP
+
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/detail/bind_signature.hpp>
+#include <dyno/detail/dsl.hpp>
+#include <dyno/detail/erase_function.hpp>
+#include <dyno/detail/erase_signature.hpp>
+#include <dyno/detail/eraser_traits.hpp>
+#include <dyno/detail/forward_param.hpp>
+#include <dyno/detail/is_placeholder.hpp>
+
+#include <boost/hana/contains.hpp>
+
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace dyno {
+
+// Table of functions dispatched on the dynamic types of two objects.
+//
+// A `dispatch_table` is parameterized on a concept and on a signature whose
+// first two parameters are placeholders, like
+// `bool (dyno::T const&, dyno::T const&, double)`. Unlike in a clause of a
+// concept, each of these two placeholders may stand for a different type.
+// Implementations are registered for pairs of types modeling the concept with
+// `define`, and the table can then be called with two `dyno::poly`s of that
+// concept (or of concepts refining it, not necessarily the same), in which
+// case the implementation registered for the pair of types held by the
+// `poly`s is called.
+//
+// The concept must refine `dyno::TypeIndex`. Each type gets a compact index
+// local to the table when it is first registered, so the table is a
+// `k * k` matrix where `k` is the number of types registered in that table,
+// regardless of the other types in the program. A call then loads the index
+// of both types from their vtable and maps it to the local index, before
+// loading the function from the matrix; there is no indirect call or chain
+// of `typeid` comparisons.
+//
+// Note that `define` may reallocate the table, so it must not be called
+// concurrently with other operations on the same table.
+template <typename Concept, typename Signature>
+struct dispatch_table;
+
+template <typename Concept, typename R, typename T1, typename T2, typename ...Args>
+struct dispatch_table<Concept, R (T1, T2, Args...)> {
+  static_assert(decltype(boost::hana::contains(dyno::clause_names(Concept{}), "type_index"_s))::value,
+    "dyno::dispatch_table: The concept of a dispatch table must refine "
+    "dyno::TypeIndex.");
+  static_assert(detail::is_placeholder<T1>::value && detail::is_placeholder<T2>::value,
+    "dyno::dispatch_table: The first two parameters of the signature of a "
+    "dispatch table must be placeholders.");
+  static_assert(!std::is_same<R, dyno::T>::value,
+    "dyno::dispatch_table: The return type of a dispatch table may not be "
+    "`dyno::T`, since it could stand for either of the two types.");
+
+  // Registers the function to call when the first object is an `A` and the
+  // second object is a `B`.
+  //
+  // The function must be a stateless function object callable with the
+  // signature obtained by replacing the first placeholder by `A` and the
+  // second placeholder by `B`. If a function was already registered for
+  // that pair of types, it is replaced.
+  template <typename A, typename B, typename Function>
+  void define(Function) {
+    static_assert(dyno::models<Concept, A> && dyno::models<Concept, B>,
+      "dyno::dispatch_table::define: The types for which a function is "
+      "registered must model the concept of the dispatch table.");
+    static_assert(std::is_empty<Function>{},
+      "dyno::dispatch_table::define: Only stateless function objects can be "
+      "used to define dispatch tables.");
+    using BoundSignature = R (typename detail::replace_impl<dyno::T, A, T1>::type,
+                              typename detail::replace_impl<dyno::T, B, T2>::type,
+                              Args...);
+    using Lambda = detail::default_constructible_lambda<Function, BoundSignature>;
+    std::size_t i = this->add_type(dyno::type_index_for<A>());
+    std::size_t j = this->add_type(dyno::type_index_for<B>());
+    table_[i * size_ + j] = detail::erase_function<R (T1, T2, Args...)>(Lambda{});
+  }
+
+  // Returns whether a function is registered for the types held by the given
+  // `poly`s.
+  template <typename Poly1, typename Poly2>
+  bool contains(Poly1 const& a, Poly2 const& b) const {
+    return lookup(local_index(a), local_index(b)) != nullptr;
+  }
+
+  // Calls the function registered for the types held by the given `poly`s.
+  //
+  // The behavior is undefined if no function was registered for that pair
+  // of types.
+  template <typename Poly1, typename Poly2, typename ...CallArgs>
+  R operator()(Poly1&& a, Poly2&& b, CallArgs&& ...args) const {
+    auto fptr = lookup(local_index(a), local_index(b));
+    assert(fptr != nullptr &&
+      "dyno::dispatch_table: No function was registered for the dynamic types "
+      "of the objects passed to the dispatch table.");
+    return fptr(dispatch_table::erase_poly<T1>(a),
+                dispatch_table::erase_poly<T2>(b),
+                detail::forward_arg<Args>(std::forward<CallArgs>(args))...);
+  }
+
+private:
+  using FunctionPtr = typename detail::erase_signature<R (T1, T2, Args...)>::type*;
+  static constexpr std::size_t none = dyno::type_index_slot::none;
+
+  // The table is a `size_ * size_` matrix of function pointers stored in
+  // row-major order, where rows are indexed by the local index of the type
+  // of the first object. `local_` maps the indices returned by
+  // `dyno::type_index_for` to local indices, or to `none` for the types
+  // that were not registered.
+  std::vector<FunctionPtr> table_;
+  std::size_t size_ = 0;
+  std::vector<std::size_t> local_;
+
+  template <typename Poly>
+  std::size_t local_index(Poly const& poly) const {
+    std::size_t index = poly.virtual_("type_index"_s)->load();
+    return index < local_.size() ? local_[index] : none;
+  }
+
+  FunctionPtr lookup(std::size_t i, std::size_t j) const {
+    return i < size_ && j < size_ ? table_[i * size_ + j] : nullptr;
+  }
+
+  // Returns the local index of the type with the given index, adding a row
+  // and a column to the table if that type was not registered yet.
+  std::size_t add_type(std::size_t index) {
+    if (index >= local_.size())
+      local_.resize(index + 1, none);
+    if (local_[index] != none)
+      return local_[index];
+
+    std::size_t size = size_ + 1;
+    std::vector<FunctionPtr> table(size * size, nullptr);
+    for (std::size_t i = 0; i != size_; ++i)
+      for (std::size_t j = 0; j != size_; ++j)
+        table[i * size + j] = table_[i * size_ + j];
+
+    table_.swap(table);
+    local_[index] = size_;
+    return size_++;
+  }
+
+  template <typename Placeholder, typename Poly>
+  static auto erase_poly(Poly& poly) {
+    using Erased = typename detail::erase_placeholder<void, Placeholder>::type;
+    return static_cast<Erased>(poly.template unsafe_get<void>());
+  }
+};
+
+} // end namespace dyno
+
+#endif // DYNO_DISPATCH_TABLE_HPP
@@ -0,0 +1,388 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#ifndef DYNO_PARALLEL_INVOKE_HPP
+#define DYNO_PARALLEL_INVOKE_HPP
+
+#include <dyno/algorithm.hpp>
+#include <dyno/detail/poly_access.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace dyno {
+
+// Options controlling how `dyno::parallel_invoke` splits the work.
+struct parallel_options {
+  // Whether to group the `poly`s by type before splitting them in chunks, so
+  // that each chunk only contains `poly`s of a single type. The calls made on
+  // a chunk then always use the same function, and the size of the chunks is
+  // computed separately for each type.
+  bool group_by_type = false;
+
+  // How long processing a chunk should take. Smaller chunks balance the work
+  // better between threads, but they are more costly to schedule.
+  std::chrono::nanoseconds chunk_duration = std::chrono::microseconds{50};
+
+  // The number of calls timed by a thread (for each type, when grouping by
+  // type) to estimate the cost of a call, from which the size of the chunks
+  // is computed.
+  std::size_t calibration_calls = 16;
+};
+
+namespace detail {
+  // A chunk of work, which is a range of positions in the sequence of `poly`s
+  // to process (see `parallel_invoke`), all in the same group.
+  struct parallel_chunk {
+    std::size_t first, last, group;
+  };
+
+  // Queue of chunks owned by a worker thread. The owner takes chunks from the
+  // front and puts back the part of a chunk it does not process right away,
+  // and the other workers steal chunks from the back when their own queue is
+  // empty. The chunks are coarse enough for a lock to be cheap.
+  struct parallel_queue {
+    bool pop(parallel_chunk& chunk) {
+      std::lock_guard<std::mutex> lock{mutex};
+      if (chunks.empty())
+        return false;
+      chunk = chunks.front();
+      chunks.pop_front();
+      return true;
+    }
+
+    void push(parallel_chunk chunk) {
+      std::lock_guard<std::mutex> lock{mutex};
+      chunks.push_front(chunk);
+    }
+
+    bool steal(parallel_chunk& chunk) {
+      std::lock_guard<std::mutex> lock{mutex};
+      if (chunks.empty())
+        return false;
+      chunk = chunks.back();
+      chunks.pop_back();
+      return true;
+    }
+
+    std::mutex mutex;
+    std::deque<parallel_chunk> chunks;
+  };
+
+  // The work done by each thread of a `dyno::parallel_executor` on a call to
+  // `dyno::parallel_invoke`, given the index of the thread. It must not throw.
+  struct parallel_job {
+    template <typename Work>
+    explicit parallel_job(Work& work)
+      : context_{&work}
+      , work_{[](void* context, std::size_t self) { (*static_cast<Work*>(context))(self); }}
+    { }
+
+    void operator()(std::size_t self) const { work_(context_, self); }
+
+  private:
+    void* context_;
+    void (*work_)(void*, std::size_t);
+  };
+
+  // Returns how many elements costing `cost` each fit in a chunk taking
+  // `duration`, but making sure that there are enough chunks of `size`
+  // elements to give several of them to each thread.
+  inline std::size_t parallel_chunk_size(std::chrono::nanoseconds duration,
+                                         std::chrono::nanoseconds cost,
+                                         std::size_t size, std::size_t threads)
+  {
+    std::size_t chunk = cost.count() <= 0 ? size : std::size_t(duration / cost);
+    std::size_t balanced = (size + 4 * threads - 1) / (4 * threads);
+    return std::max<std::size_t>(1, std::min(chunk, balanced));
+  }
+} // end namespace detail
+
+// Pool of threads used by `dyno::parallel_invoke`, along with the queue of
+// chunks of each thread.
+//
+// The threads are started when the executor is created, and they wait for
+// work until the executor is destroyed, so calling `dyno::parallel_invoke`
+// repeatedly (e.g. once per frame) does not start any thread. The thread
+// calling `dyno::parallel_invoke` takes part in the work, so an executor with
+// `threads` threads starts `threads - 1` of them. Calls to
+// `dyno::parallel_invoke` using the same executor from several threads are
+// serialized, and a call made from inside a call using the same executor
+// deadlocks.
+class parallel_executor {
+public:
+  // Starts the threads. When `threads` is 0, the number of hardware threads
+  // is used. If a thread can't be started, the threads already started are
+  // stopped and joined before the exception is propagated.
+  explicit parallel_executor(std::size_t threads = 0)
+    : queues_(std::max<std::size_t>(1, threads != 0 ? threads : std::thread::hardware_concurrency()))
+  {
+    try {
+      workers_.reserve(queues_.size() - 1);
+      for (std::size_t t = 1; t != queues_.size(); ++t)
+        workers_.emplace_back([this, t] { this->wait_for_work(t); });
+    } catch (...) {
+      this->stop();
+      throw;
+    }
+  }
+
+  parallel_executor(parallel_executor const&) = delete;
+  parallel_executor& operator=(parallel_executor const&) = delete;
+
+  ~parallel_executor() { this->stop(); }
+
+  // Returns the number of threads doing the work, including the calling
+  // thread.
+  std::size_t threads() const { return queues_.size(); }
+
+  // Returns an executor using all the hardware threads, which is created the
+  // first time this is called. This is the executor used when none is given
+  // to `dyno::parallel_invoke`.
+  static parallel_executor& shared() {
+    static parallel_executor executor;
+    return executor;
+  }
+
+private:
+  template <typename Iterator, typename Function, typename ...Args>
+  friend void parallel_invoke(parallel_executor&, parallel_options const&,
+                              Iterator, Iterator, Function, Args&& ...);
+
+  // Runs the job on all the threads, and returns once they are all done.
+  void run(detail::parallel_job job) {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      job_ = &job;
+      running_ = workers_.size();
+      ++generation_;
+    }
+    wake_.notify_all();
+    job(0);
+    std::unique_lock<std::mutex> lock{mutex_};
+    done_.wait(lock, [&] { return running_ == 0; });
+  }
+
+  void wait_for_work(std::size_t self) {
+    std::size_t seen = 0;
+    std::unique_lock<std::mutex> lock{mutex_};
+    while (true) {
+      wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+      if (stop_)
+        return;
+      seen = generation_;
+      detail::parallel_job const* job = job_;
+      lock.unlock();
+      (*job)(self);
+      lock.lock();
+      if (--running_ == 0)
+        done_.notify_one();
+    }
+  }
+
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_)
+      worker.join();
+  }
+
+  std::vector<detail::parallel_queue> queues_;
+  std::vector<std::thread> workers_;
+  // Serializes the calls to `dyno::parallel_invoke`.
+  std::mutex calls_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  detail::parallel_job const* job_ = nullptr;
+  std::size_t generation_ = 0;
+  std::size_t running_ = 0;
+  bool stop_ = false;
+};
+
+// Calls the function with the given name on each `dyno::poly` in the range
+// `[first, last)`, with the given arguments, using the threads of the given
+// executor (or of `dyno::parallel_executor::shared()` when none is given).
+//
+// The range is split in one chunk per thread (and per type, when grouping by
+// type), which are distributed evenly between the threads. Each thread then
+// splits the chunks it processes into smaller chunks, whose size is computed
+// from the cost of a call, and puts them back in its queue. When a thread runs
+// out of chunks, it steals chunks from the other threads, so the work stays
+// balanced even when some calls are much more expensive than others. The
+// cost of a call is estimated by each thread by timing the first few calls it
+// makes on a type it has not seen yet, so no call is made before the work is
+// split. When the `poly`s are grouped by type (see `parallel_options`), the
+// cost is estimated separately for each type, since it often depends on it.
+//
+// The iterators must be random access. The calls are made in an unspecified
+// order, but on each `poly` exactly once, and the arguments are shared by all
+// the calls (as lvalues), so the function must not modify them unless that
+// is thread-safe. If a call throws an exception, no new chunk is started and
+// the exception is rethrown once all the threads are done.
+//
+// Like for `dyno::invoke_each`, the function must be a method, or a function
+// whose first parameter is a placeholder.
+//
+// Since this requires linking with the threads library, this header is not
+// included by `dyno.hpp`; link with the `Dyno::parallel` CMake target to use
+// it.
+template <typename Iterator, typename Function, typename ...Args>
+void parallel_invoke(parallel_executor& executor, parallel_options const& options,
+                     Iterator first, Iterator last, Function name, Args&& ...args)
+{
+  static_assert(std::is_base_of<std::random_access_iterator_tag,
+                  typename std::iterator_traits<Iterator>::iterator_category>::value,
+    "dyno::parallel_invoke: The iterators must be random access iterators.");
+  using Clock = std::chrono::steady_clock;
+
+  std::size_t const size = static_cast<std::size_t>(last - first);
+  if (size == 0)
+    return;
+  std::size_t const threads = std::min(executor.threads(), size);
+
+  // The positions of the `poly`s to process. When grouping by type, they are
+  // sorted by group, and `groups` contains the end of each group.
+  std::vector<std::size_t> order;
+  std::vector<std::size_t> groups;
+  if (options.group_by_type) {
+    using FunctionPtr = decltype(detail::poly_access::lookup(*first, name));
+    detail::group_by<FunctionPtr> group_of;
+    std::vector<std::size_t> group(size);
+    for (std::size_t i = 0; i != size; ++i) {
+      group[i] = group_of(detail::poly_access::lookup(first[i], name));
+      if (group[i] == groups.size())
+        groups.push_back(0);
+      ++groups[group[i]];
+    }
+    std::vector<std::size_t> next(groups.size());
+    for (std::size_t g = 0, end = 0; g != groups.size(); ++g) {
+      next[g] = end;
+      end += groups[g];
+      groups[g] = end;
+    }
+    order.resize(size);
+    for (std::size_t i = 0; i != size; ++i)
+      order[next[group[i]]++] = i;
+  } else {
+    groups.push_back(size);
+  }
+
+  auto call = [&](std::size_t position) {
+    auto&& poly = first[order.empty() ? position : order[position]];
+    detail::poly_access::bind(poly, name, detail::poly_access::lookup(poly, name))(args...);
+  };
+
+  // The size of the chunks of each group, or 0 until a thread has estimated
+  // the cost of a call for that group.
+  std::vector<std::atomic<std::size_t>> chunk_sizes(groups.size());
+  for (std::atomic<std::size_t>& chunk_size : chunk_sizes)
+    chunk_size.store(0, std::memory_order_relaxed);
+
+  std::lock_guard<std::mutex> calls{executor.calls_};
+  std::vector<detail::parallel_queue>& queues = executor.queues_;
+  for (std::size_t g = 0, begin = 0; g != groups.size(); begin = groups[g++]) {
+    std::size_t const n = groups[g] - begin;
+    for (std::size_t t = 0; t != threads; ++t) {
+      detail::parallel_chunk chunk{begin + n * t / threads, begin + n * (t + 1) / threads, g};
+      if (chunk.first != chunk.last)
+        queues[t].chunks.push_back(chunk);
+    }
+  }
+
+  std::atomic<bool> failed{false};
+  std::exception_ptr exception;
+  std::mutex exception_mutex;
+  auto work = [&](std::size_t self) {
+    if (self >= threads)
+      return;
+    detail::parallel_chunk chunk;
+    while (!failed.load(std::memory_order_relaxed)) {
+      // Chunks are only put back by the thread that took them, before it
+      // processes the front of the chunk, so there is no work left when all
+      // the queues are empty.
+      bool found = queues[self].pop(chunk);
+      for (std::size_t t = 1; !found && t != threads; ++t)
+        found = queues[(self + t) % threads].steal(chunk);
+      if (!found)
+        return;
+
+      try {
+        std::size_t chunk_size = chunk_sizes[chunk.group].load(std::memory_order_relaxed);
+        bool const calibrating = chunk_size == 0;
+        if (calibrating)
+          chunk_size = std::max<std::size_t>(1, options.calibration_calls);
+        std::size_t split = chunk.first + std::min(chunk_size, chunk.last - chunk.first);
+        if (split != chunk.last)
+          queues[self].push({split, chunk.last, chunk.group});
+
+        auto start = calibrating ? Clock::now() : Clock::time_point{};
+        for (std::size_t p = chunk.first; p != split; ++p)
+          call(p);
+        if (calibrating) {
+          auto cost = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        (Clock::now() - start) / (split - chunk.first));
+          std::size_t begin = chunk.group == 0 ? 0 : groups[chunk.group - 1];
+          chunk_sizes[chunk.group].store(
+            detail::parallel_chunk_size(options.chunk_duration, cost,
+                                        groups[chunk.group] - begin, threads),
+            std::memory_order_relaxed);
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock{exception_mutex};
+        if (!exception)
+          exception = std::current_exception();
+        failed.store(true, std::memory_order_relaxed);
+      }
+    }
+  };
+  executor.run(detail::parallel_job{work});
+
+  // The chunks left when a call throws are dropped, so the queues are empty
+  // for the next call.
+  for (std::size_t t = 0; t != threads; ++t)
+    queues[t].chunks.clear();
+
+  if (exception)
+    std::rethrow_exception(exception);
+}
+
+template <typename Iterator, typename Function, typename ...Args>
+void parallel_invoke(parallel_options const& options, Iterator first, Iterator last,
+                     Function name, Args&& ...args) {
+  dyno::parallel_invoke(parallel_executor::shared(), options, first, last, name,
+                        std::forward<Args>(args)...);
+}
+
+template <typename Iterator, typename Function, typename ...Args>
+void parallel_invoke(parallel_executor& executor, Iterator first, Iterator last,
+                     Function name, Args&& ...args) {
+  dyno::parallel_invoke(executor, parallel_options{}, first, last, name,
+                        std::forward<Args>(args)...);
+}
+
+template <typename Iterator, typename Function, typename ...Args>
+void parallel_invoke(Iterator first, Iterator last, Function name, Args&& ...args) {
+  dyno::parallel_invoke(parallel_executor::shared(), parallel_options{}, first, last,
+                        name, std::forward<Args>(args)...);
+}
+
+} // end namespace dyno
+
+#endif // DYNO_PARALLEL_INVOKE_HPP
@@ -8,21 +8,37 @@
 #include <dyno/builtin.hpp>
 #include <dyno/concept.hpp>
 #include <dyno/concept_map.hpp>
+#include <dyno/detail/eraser_traits.hpp>
+#include <dyno/detail/forward_param.hpp>
 #include <dyno/detail/is_placeholder.hpp>
 #include <dyno/storage.hpp>
 #include <dyno/vtable.hpp>
 
 #include <boost/hana/contains.hpp>
 #include <boost/hana/core/to.hpp>
+#include <boost/hana/is_subset.hpp>
 #include <boost/hana/map.hpp>
+#include <boost/hana/set.hpp>
 #include <boost/hana/unpack.hpp>
 
+#include <new>
 #include <type_traits>
 #include <utility>
 
 
 namespace dyno {
 
+namespace detail {
+  // Gives access to the internals of `dyno::poly` to the algorithms and the
+  // containers operating on many `poly`s at once, see `dyno/algorithm.hpp`.
+  struct poly_access;
+
+  // Tag for constructing a `poly` referencing an object whose vtable is
+  // stored separately, see `poly_access::reference`.
+  struct reference_object_t { };
+  constexpr reference_object_t reference_object{};
+}
+
 // A `dyno::poly` encapsulates an object of a polymorphic type that supports the
 // interface of the given `Concept`.
 //
@@ -66,15 +82,73 @@ template <
 >
 struct poly {
 private:
+  // The builtin concepts are listed first, so that the functions of the
+  // first concept refined by `Concept` come right after them in the vtable.
+  // This way, the vtable of a `poly` of that refined concept is a prefix of
+  // our vtable, which makes converting to such a `poly` free.
   using ActualConcept = decltype(dyno::requires(
-    Concept{},
     dyno::Destructible{},
-    dyno::Storable{}
+    dyno::Storable{},
+    Concept{}
   ));
   using VTable = typename VTablePolicy::template apply<ActualConcept>;
 
+  template <typename, typename, typename>
+  friend struct poly;
+  friend struct detail::poly_access;
+
+  // Whether `OtherConcept` provides all the functions required by `Concept`,
+  // which is the case when it is `Concept` or refines it.
+  template <typename OtherConcept>
+  static constexpr bool is_refined_by =
+    decltype(boost::hana::is_subset(boost::hana::to_set(dyno::clause_names(Concept{})),
+                                    boost::hana::to_set(dyno::clause_names(OtherConcept{}))))::value;
+
+  // Whether `T` is a `poly` that can be converted to this `poly` using the
+  // converting constructor below (instead of being wrapped as an object).
+  template <typename T>
+  struct is_convertible_poly : std::false_type { };
+
+  template <typename OtherConcept, typename OtherStorage>
+  struct is_convertible_poly<poly<OtherConcept, OtherStorage, VTablePolicy>>
+    : std::integral_constant<bool,
+        !std::is_same<poly<OtherConcept, OtherStorage, VTablePolicy>, poly>::value &&
+        is_refined_by<OtherConcept>
+      >
+  { };
+
+  template <typename T>
+  struct is_in_place_type : std::false_type { };
+
+  template <typename T>
+  struct is_in_place_type<std::in_place_type_t<T>> : std::true_type { };
+
+  // Whether the storage can be reused for a new object, see `reset` in the
+  // documentation of the `PolymorphicStorage` concept.
+  template <typename S, typename = void>
+  struct has_reset : std::false_type { };
+
+  template <typename S>
+  struct has_reset<S, std::void_t<decltype(
+    std::declval<S&>().reset(std::declval<VTable const&>(), std::declval<dyno::storage_info>())
+  )>> : std::true_type { };
+
+  // Whether the storage can be constructed by a function constructing the
+  // object in place, which is required for functions returning `dyno::T`
+  // by value. See `in_place_construct_t` in the documentation of the
+  // `PolymorphicStorage` concept.
+  template <typename S, typename = void>
+  struct has_in_place_construct : std::false_type { };
+
+  template <typename S>
+  struct has_in_place_construct<S, std::void_t<decltype(
+    S{dyno::in_place_construct, std::declval<VTable const&>(), std::declval<void (&)(void*)>()}
+  )>> : std::true_type { };
+
 public:
-  template <typename T, typename RawT = std::decay_t<T>, typename ConceptMap>
+  template <typename T, typename RawT = std::decay_t<T>, typename ConceptMap,
+    typename = std::enable_if_t<!is_in_place_type<RawT>::value>
+  >
   poly(T&& t, ConceptMap map)
     : vtable_{dyno::complete_concept_map<ActualConcept, RawT>(map)}
     , storage_{std::forward<T>(t)}
@@ -82,29 +156,97 @@ public:
 
   template <typename T, typename RawT = std::decay_t<T>,
     typename = std::enable_if_t<!std::is_same<RawT, poly>::value>,
+    typename = std::enable_if_t<!is_convertible_poly<RawT>::value>,
+    typename = std::enable_if_t<!is_in_place_type<RawT>::value>,
     typename = std::enable_if_t<dyno::models<ActualConcept, RawT>>
   >
   poly(T&& t)
     : poly{std::forward<T>(t), dyno::concept_map<ActualConcept, RawT>}
   { }
 
+  // Constructs an object of type `T` directly inside the storage of the
+  // `poly`, forwarding the arguments to its constructor (or using them to
+  // aggregate-initialize it). Unlike the other constructors, this does not
+  // create a temporary object, so `T` does not need to be movable.
+  template <typename T, typename ...Args,
+    typename = std::enable_if_t<dyno::models<ActualConcept, T>>
+  >
+  explicit poly(std::in_place_type_t<T>, Args&& ...args)
+    : vtable_{dyno::complete_concept_map<ActualConcept, T>(dyno::concept_map<ActualConcept, T>)}
+    , storage_{std::in_place_type<T>, std::forward<Args>(args)...}
+  { }
+
   poly(poly const& other)
     : vtable_{other.vtable_}
     , storage_{other.storage_, vtable_}
   { }
 
+  // This is `noexcept` whenever moving the storage is, so that containers of
+  // `poly`s move them instead of copying them when they grow.
   poly(poly&& other)
+    noexcept(std::is_nothrow_constructible<Storage, Storage&&, VTable const&>::value)
     : vtable_{std::move(other.vtable_)}
     , storage_{std::move(other.storage_), vtable_}
   { }
 
+  // Converts a `poly` of `Concept` or of a concept refining `Concept`, and
+  // which may use a different storage policy, to this `poly`, without
+  // re-erasing the object held by `other`.
+  //
+  // The storage is constructed from the storage of `other`, which determines
+  // what happens to the object. For example, moving steals the object held
+  // by `other` whenever the storage policy allows it, and a non-owning
+  // storage references the object held by `other`.
+  //
+  // The vtable is converted from the vtable of `other`. When using a remote
+  // vtable, this requires `Concept` to be either the concept of `other` or
+  // the first concept refined by it, in which case the functions of `Concept`
+  // are at the beginning of the other vtable and no new vtable is created.
+  template <typename Other,
+    typename RawOther = std::remove_cv_t<std::remove_reference_t<Other>>,
+    std::enable_if_t<is_convertible_poly<RawOther>::value>* = nullptr
+  >
+  poly(Other&& other)
+    : vtable_{detail::from_vtable, other.vtable_}
+    , storage_{static_cast<Other&&>(other).storage_, other.vtable_}
+  { }
+
+  // When the storage supports it and the object held by `other` can be
+  // copied without throwing, the object held by `*this` is destroyed and a
+  // copy of `other` is constructed in its place, which avoids allocating when
+  // `*this` is already holding enough memory. Otherwise, a copy of `other` is
+  // swapped with `*this`, which leaves `*this` unchanged if copying throws.
+  // Furthermore, if `Concept` includes `dyno::CopyAssignable` and both `poly`s
+  // hold objects of the same type, the object held by `other` is simply
+  // assigned to the object held by `*this`, which reuses the resources it
+  // holds.
   poly& operator=(poly const& other) {
-    poly(other).swap(*this);
+    if constexpr (has_reset<Storage>::value) {
+      if (this->try_assign(other, "copy-assign"_s)) {
+        // Nothing to do.
+      } else if (this != &other) {
+        if (other.storage_.get() != nullptr &&
+            other.vtable_["storage_info"_s].nothrow_copy_constructible) {
+          void* where = storage_.reset(vtable_, other.vtable_["storage_info"_s]);
+          other.vtable_["copy-construct"_s](where, other.storage_.get());
+          vtable_ = other.vtable_;
+        } else {
+          poly(other).swap(*this);
+        }
+      }
+    } else {
+      poly(other).swap(*this);
+    }
     return *this;
   }
 
+  // If `Concept` includes `dyno::MoveAssignable` and both `poly`s hold objects
+  // of the same type, the object held by `other` is move-assigned to the object
+  // held by `*this`. Otherwise, the object held by `other` is moved into a new
+  // `poly` that is then swapped with `*this`.
   poly& operator=(poly&& other) {
-    poly(std::move(other)).swap(*this);
+    if (!this->try_assign(other, "move-assign"_s))
+      poly(std::move(other)).swap(*this);
     return *this;
   }
 
@@ -116,6 +258,41 @@ public:
 
   friend void swap(poly& a, poly& b) { a.swap(b); }
 
+  // Destroys the object held by the `poly` and constructs an object of type
+  // `T` in its place, like the in-place constructor. Returns a reference to
+  // the new object. When the storage supports it and the constructor of `T`
+  // does not throw, the memory held by the storage is reused for the new
+  // object. Otherwise, the new object is constructed in a new `poly` that is
+  // swapped with `*this`, which leaves `*this` unchanged if the constructor
+  // throws. This requires `Concept` to include `dyno::MoveConstructible`,
+  // unless the memory of the storage can be reused, or constructing the
+  // storage does not throw.
+  template <typename T, typename ...Args,
+    typename = std::enable_if_t<dyno::models<ActualConcept, T>>
+  >
+  T& emplace(Args&& ...args) {
+    constexpr bool nothrow = detail::is_nothrow_constructible_at<T, Args...>();
+    constexpr bool movable = decltype(vtable_.contains("move-construct"_s))::value;
+    if constexpr (has_reset<Storage>::value && nothrow) {
+      void* where = storage_.reset(vtable_, dyno::storage_info_for<T>);
+      detail::construct_at<T>(where, std::forward<Args>(args)...);
+      vtable_ = VTable{dyno::complete_concept_map<ActualConcept, T>(dyno::concept_map<ActualConcept, T>)};
+    } else if constexpr (movable) {
+      poly(std::in_place_type<T>, std::forward<Args>(args)...).swap(*this);
+    } else {
+      static_assert(std::is_nothrow_constructible<Storage, std::in_place_type_t<T>, Args&&...>::value,
+        "dyno::poly::emplace: Trying to emplace an object in a poly whose concept "
+        "does not include dyno::MoveConstructible, but the constructor of the "
+        "object may throw, or the storage may throw when allocating memory for "
+        "it. The poly could not be left unchanged if that happens.");
+      storage_.destruct(vtable_);
+      storage_.~Storage();
+      new (&storage_) Storage{std::in_place_type<T>, std::forward<Args>(args)...};
+      vtable_ = VTable{dyno::complete_concept_map<ActualConcept, T>(dyno::concept_map<ActualConcept, T>)};
+    }
+    return *storage_.template get<T>();
+  }
+
   ~poly() { storage_.destruct(vtable_); }
 
   template <typename ...T, typename Name, typename ...Args>
@@ -161,6 +338,48 @@ public:
                              "that is not part of the Concept");
   }
 
+  // Returns a callable bound to this `poly` for the given function.
+  //
+  // The function pointer is looked up in the vtable and the underlying storage
+  // is resolved once, when `bind` is called, and both are stored inside the
+  // returned callable. Calling it then only performs the indirect call, which
+  // is useful when the same function is called repeatedly on the same `poly`.
+  // The function must be a method, or a function whose first parameter is a
+  // placeholder, in which case this `poly` is passed as that parameter.
+  //
+  // The returned callable is potentially invalidated whenever the poly is
+  // modified, in the same way as pointers returned by `unsafe_get`.
+  template <typename Function,
+    bool HasClause = decltype(boost::hana::contains(dyno::clause_names(Concept{}), Function{})){},
+    std::enable_if_t<HasClause>* = nullptr
+  >
+  constexpr auto bind(Function name) const& {
+    auto clauses = boost::hana::to_map(dyno::clauses(Concept{}));
+    return bind_impl(clauses[name], name, storage_.get());
+  }
+  template <typename Function,
+    bool HasClause = decltype(boost::hana::contains(dyno::clause_names(Concept{}), Function{})){},
+    std::enable_if_t<HasClause>* = nullptr
+  >
+  constexpr auto bind(Function name) & {
+    auto clauses = boost::hana::to_map(dyno::clauses(Concept{}));
+    return bind_impl(clauses[name], name, storage_.get());
+  }
+  template <typename Function,
+    bool HasClause = decltype(boost::hana::contains(dyno::clause_names(Concept{}), Function{})){},
+    std::enable_if_t<HasClause>* = nullptr
+  >
+  constexpr void bind(Function name) && = delete;
+
+  template <typename Function,
+    bool HasClause = decltype(boost::hana::contains(dyno::clause_names(Concept{}), Function{})){},
+    std::enable_if_t<!HasClause>* = nullptr
+  >
+  constexpr void bind(Function) const {
+    static_assert(HasClause, "dyno::poly::bind: Trying to bind a function "
+                             "that is not part of the Concept");
+  }
+
   // Returns a pointer to the underlying storage.
   //
   // The pointer is potentially invalidated whenever the poly is modified;
@@ -179,64 +398,320 @@ private:
   VTable vtable_;
   Storage storage_;
 
+  // Constructs a `poly` using the given vtable, whose object is constructed
+  // directly inside the storage by `construct`.
+  template <typename Construct>
+  poly(dyno::in_place_construct_t, VTable const& vtable, Construct&& construct)
+    : vtable_{vtable}
+    , storage_{dyno::in_place_construct, vtable_, static_cast<Construct&&>(construct)}
+  { }
+
+  // Constructs a `poly` using the given vtable, whose (non-owning) storage
+  // references the object held by `object`, which looks like a storage.
+  template <typename Object>
+  poly(detail::reference_object_t, VTable const& vtable, Object& object)
+    : vtable_{vtable}
+    , storage_{object, vtable_}
+  { }
+
+  // Callable used in place of the function pointer of a function returning
+  // `dyno::T` by value. The function pointer constructs its result directly
+  // inside the storage of a new `poly`, which uses the same vtable as the
+  // `poly` the function was looked up in, since the result has the same type
+  // as the object held by that `poly`. No temporary object is created.
+  template <typename FunctionPtr>
+  struct placeholder_result {
+    FunctionPtr fptr;
+    VTable const* vtable;
+
+    template <typename ...Args>
+    poly operator()(Args&& ...args) const {
+      return poly{dyno::in_place_construct, *vtable, [&](void* result) {
+        fptr(result, static_cast<Args&&>(args)...);
+      }};
+    }
+  };
+
+  // Looks up a function returning `R` in the vtable. Functions returning
+  // `dyno::T` by value are wrapped as explained above.
+  template <typename R, typename Function>
+  constexpr auto lookup(Function name) const {
+    if constexpr (std::is_same<R, dyno::T>::value) {
+      static_assert(has_in_place_construct<Storage>::value,
+        "dyno::poly: Functions returning `dyno::T` by value can only be called "
+        "on a poly whose storage policy supports `dyno::in_place_construct`, "
+        "since their result is constructed inside a new poly.");
+      using FunctionPtr = std::decay_t<decltype(vtable_[name])>;
+      return placeholder_result<FunctionPtr>{vtable_[name], &vtable_};
+    } else {
+      return vtable_[name];
+    }
+  }
+
+  // Assigns the object held by `other` to the object held by `*this` using
+  // the given function of the vtable, if both objects are known to be of the
+  // same type, and returns whether that was done. This is only done for
+  // storages that own their object exclusively (those that can be `reset`),
+  // since assigning to a shared or referenced object would not have the
+  // right semantics.
+  template <typename Other, typename Name>
+  bool try_assign(Other& other, Name name) {
+    if constexpr (has_reset<Storage>::value &&
+                  decltype(vtable_.contains(name))::value) {
+      // The types may not be assignable, and moved-from storages may not hold
+      // an object anymore.
+      auto assign = vtable_[name];
+      if (assign != nullptr && vtable_.same_concept_map(other.vtable_) &&
+          storage_.get() != nullptr && other.storage_.get() != nullptr) {
+        assign(storage_.get(), other.storage_.get());
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Handle dyno::constant; the value is returned directly.
+  template <typename Type, typename Function>
+  constexpr Type virtual_impl(dyno::constant_t<Type>, Function name) const {
+    return vtable_[name];
+  }
+
+  // Handle dyno::field; a reference to the member is returned. When the
+  // storage only gives access to a const object (e.g. for a `poly_cref`), the
+  // first overload is disabled and a const reference is always returned.
+  template <typename Type, typename Function, typename S = Storage,
+    std::enable_if_t<!std::is_const<
+      std::remove_pointer_t<decltype(std::declval<S&>().get())>
+    >::value>* = nullptr
+  >
+  Type& virtual_impl(dyno::field_t<Type>, Function name) & {
+    char* object = static_cast<char*>(storage_.get());
+    return *static_cast<Type*>(static_cast<void*>(object + vtable_[name]));
+  }
+  template <typename Type, typename Function>
+  Type const& virtual_impl(dyno::field_t<Type>, Function name) const& {
+    char const* object = static_cast<char const*>(storage_.get());
+    return *static_cast<Type const*>(static_cast<void const*>(object + vtable_[name]));
+  }
+
   // Handle dyno::function
-  template <typename R, typename ...T, typename Function>
-  constexpr decltype(auto) virtual_impl(dyno::function_t<R(T...)>, Function name) const {
-    auto fptr = vtable_[name];
-    return [fptr](auto&& ...args) -> decltype(auto) {
+  //
+  // The callables returned below are `noexcept` whenever calling the function
+  // pointer is, which is the case when the function is declared `noexcept` in
+  // the concept and the arguments can be converted without throwing.
+  template <typename R, typename ...T, bool NoExcept, typename Function>
+  constexpr decltype(auto) virtual_impl(dyno::function_t<R(T...) noexcept(NoExcept)>, Function name) const {
+    auto fptr = lookup<R>(name);
+    return [fptr](auto&& ...args)
+      noexcept(noexcept(fptr(poly::unerase_poly<T>(static_cast<decltype(args)&&>(args))...)))
+      -> decltype(auto)
+    {
       return fptr(poly::unerase_poly<T>(static_cast<decltype(args)&&>(args))...);
     };
   }
 
   // Handle dyno::method
-  template <typename R, typename ...T, typename Function>
-  constexpr decltype(auto) virtual_impl(dyno::method_t<R(T...)>, Function name) & {
-    auto fptr = vtable_[name];
-    return [fptr, this](auto&& ...args) -> decltype(auto) {
+  template <typename R, typename ...T, bool NoExcept, typename Function>
+  constexpr decltype(auto) virtual_impl(dyno::method_t<R(T...) noexcept(NoExcept)>, Function name) & {
+    auto fptr = lookup<R>(name);
+    return [fptr, this](auto&& ...args)
+      noexcept(noexcept(fptr(poly::unerase_poly<dyno::T&>(*this),
+                             poly::unerase_poly<T>(static_cast<decltype(args)&&>(args))...)))
+      -> decltype(auto)
+    {
       return fptr(poly::unerase_poly<dyno::T&>(*this),
                   poly::unerase_poly<T>(static_cast<decltype(args)&&>(args))...);
     };
   }
-  template <typename R, typename ...T, typename Function>
-  constexpr decltype(auto) virtual_impl(dyno::method_t<R(T...)&>, Function name) & {
-    auto fptr = vtable_[name];
-    return [fptr, this](auto&& ...args) -> decltype(auto) {
+  template <typename R, typename ...T, bool NoExcept, typename Function>
+  constexpr decltype(auto) virtual_impl(dyno::method_t<R(T...) & noexcept(NoExcept)>, Function name) & {
+    auto fptr = lookup<R>(name);
+    return [fptr, this](auto&& ...args)
+      noexcept(noexcept(fptr(poly::unerase_poly<dyno::T&>(*this),
+                             poly::unerase_poly<T>(static_cast<decltype(args)&&>(args))...)))
+      -> decltype(auto)
+    {
       return fptr(poly::unerase_poly<dyno::T&>(*this),
                   poly::unerase_poly<T>(static_cast<decltype(args)&&>(args))...);
     };
   }
-  template <typename R, typename ...T, typename Function>
-  constexpr decltype(auto) virtual_impl(dyno::method_t<R(T...)&&>, Function name) && {
-    auto fptr = vtable_[name];
-    return [fptr, this](auto&& ...args) -> decltype(auto) {
+  template <typename R, typename ...T, bool NoExcept, typename Function>
+  constexpr decltype(auto) virtual_impl(dyno::method_t<R(T...) && noexcept(NoExcept)>, Function name) && {
+    auto fptr = lookup<R>(name);
+    return [fptr, this](auto&& ...args)
+      noexcept(noexcept(fptr(poly::unerase_poly<dyno::T&&>(*this),
+                             poly::unerase_poly<T>(static_cast<decltype(args)&&>(args))...)))
+      -> decltype(auto)
+    {
       return fptr(poly::unerase_poly<dyno::T&&>(*this),
                   poly::unerase_poly<T>(static_cast<decltype(args)&&>(args))...);
     };
   }
-  template <typename R, typename ...T, typename Function>
-  constexpr decltype(auto) virtual_impl(dyno::method_t<R(T...) const>, Function name) const {
-    auto fptr = vtable_[name];
-    return [fptr, this](auto&& ...args) -> decltype(auto) {
+  template <typename R, typename ...T, bool NoExcept, typename Function>
+  constexpr decltype(auto) virtual_impl(dyno::method_t<R(T...) const noexcept(NoExcept)>, Function name) const {
+    auto fptr = lookup<R>(name);
+    return [fptr, this](auto&& ...args)
+      noexcept(noexcept(fptr(poly::unerase_poly<dyno::T const&>(*this),
+                             poly::unerase_poly<T>(static_cast<decltype(args)&&>(args))...)))
+      -> decltype(auto)
+    {
       return fptr(poly::unerase_poly<dyno::T const&>(*this),
                   poly::unerase_poly<T>(static_cast<decltype(args)&&>(args))...);
     };
   }
-  template <typename R, typename ...T, typename Function>
-  constexpr decltype(auto) virtual_impl(dyno::method_t<R(T...) const&>, Function name) const {
-    auto fptr = vtable_[name];
-    return [fptr, this](auto&& ...args) -> decltype(auto) {
+  template <typename R, typename ...T, bool NoExcept, typename Function>
+  constexpr decltype(auto) virtual_impl(dyno::method_t<R(T...) const& noexcept(NoExcept)>, Function name) const {
+    auto fptr = lookup<R>(name);
+    return [fptr, this](auto&& ...args)
+      noexcept(noexcept(fptr(poly::unerase_poly<dyno::T const&>(*this),
+                             poly::unerase_poly<T>(static_cast<decltype(args)&&>(args))...)))
+      -> decltype(auto)
+    {
       return fptr(poly::unerase_poly<dyno::T const&>(*this),
                   poly::unerase_poly<T>(static_cast<decltype(args)&&>(args))...);
     };
   }
 
+  // Handle dyno::batch_function; the function is applied to the object held
+  // by the poly alone.
+  template <typename ...T, bool NoExcept, typename Function>
+  constexpr auto virtual_impl(dyno::batch_function_t<void(dyno::T*, std::size_t, T...) noexcept(NoExcept)> f, Function name) & {
+    return poly::bind_function(f, vtable_[name], storage_.get());
+  }
+  template <typename ...T, bool NoExcept, typename Function>
+  constexpr auto virtual_impl(dyno::batch_function_t<void(dyno::T const*, std::size_t, T...) noexcept(NoExcept)> f, Function name) const {
+    return poly::bind_function(f, vtable_[name], storage_.get());
+  }
+
+  // Handle `bind`; methods are handled by binding their implicit first argument.
+  template <typename Signature>
+  static constexpr auto as_function(dyno::method_t<Signature>)
+  { return dyno::function_t<typename dyno::method_t<Signature>::type>{}; }
+
+  template <typename Signature>
+  static constexpr auto as_function(dyno::function_t<Signature> f)
+  { return f; }
+
+  template <typename Signature>
+  static constexpr auto as_function(dyno::batch_function_t<Signature> f)
+  { return f; }
+
+  template <typename Clause, typename Function, typename Self>
+  constexpr auto bind_impl(Clause clause, Function name, Self self) const {
+    return bind_with(poly::as_function(clause), name, self);
+  }
+
+  template <typename R, typename ...T, bool NoExcept, typename Function, typename Self>
+  constexpr auto bind_with(dyno::function_t<R(T...) noexcept(NoExcept)> f, Function name, Self self) const {
+    return poly::bind_function(f, lookup<R>(name), self);
+  }
+
+  template <typename Signature, typename Function, typename Self>
+  constexpr auto bind_with(dyno::batch_function_t<Signature> f, Function name, Self self) const {
+    return poly::bind_function(f, vtable_[name], self);
+  }
+
+  // Like `bind`, except the function is given instead of being looked up in
+  // the vtable. It must have been looked up in the vtable of a `poly` holding
+  // an object of the same type. This is used by `dyno::invoke_each`, which
+  // looks up a function once for many `poly`s.
+  template <typename Function, typename FunctionPtr>
+  constexpr auto bind_resolved(Function name, FunctionPtr fptr) & {
+    auto clauses = boost::hana::to_map(dyno::clauses(Concept{}));
+    using Clause = decltype(poly::as_function(clauses[name]));
+    static_assert(!poly::returns_placeholder(Clause{}),
+      "dyno::poly: Functions returning `dyno::T` by value can't be called on "
+      "many polys at once.");
+    return poly::bind_function(Clause{}, fptr, storage_.get());
+  }
+  template <typename Function, typename FunctionPtr>
+  constexpr auto bind_resolved(Function name, FunctionPtr fptr) const& {
+    auto clauses = boost::hana::to_map(dyno::clauses(Concept{}));
+    using Clause = decltype(poly::as_function(clauses[name]));
+    static_assert(!poly::returns_placeholder(Clause{}),
+      "dyno::poly: Functions returning `dyno::T` by value can't be called on "
+      "many polys at once.");
+    return poly::bind_function(Clause{}, fptr, storage_.get());
+  }
+
+  // Like `bind_resolved`, but for a batch function applied to the array of
+  // `size` objects starting with the object held by this `poly`. This is used
+  // by containers storing objects of the same type contiguously.
+  template <typename Function, typename FunctionPtr>
+  constexpr auto bind_resolved_batch(Function name, FunctionPtr fptr, std::size_t size) & {
+    auto clauses = boost::hana::to_map(dyno::clauses(Concept{}));
+    return poly::bind_function(clauses[name], fptr, storage_.get(), size);
+  }
+  template <typename Function, typename FunctionPtr>
+  constexpr auto bind_resolved_batch(Function name, FunctionPtr fptr, std::size_t size) const& {
+    auto clauses = boost::hana::to_map(dyno::clauses(Concept{}));
+    return poly::bind_function(clauses[name], fptr, storage_.get(), size);
+  }
+
+  template <typename R, typename ...T, bool NoExcept>
+  static constexpr bool returns_placeholder(dyno::function_t<R(T...) noexcept(NoExcept)>)
+  { return std::is_same<R, dyno::T>::value; }
+
+  template <typename Signature>
+  static constexpr bool returns_placeholder(dyno::batch_function_t<Signature>)
+  { return false; }
+
+  template <typename R, typename T0, typename ...T, bool NoExcept, typename FunctionPtr, typename Self>
+  static constexpr auto bind_function(dyno::function_t<R(T0, T...) noexcept(NoExcept)>, FunctionPtr fptr, Self self) {
+    static_assert(detail::is_placeholder<T0>::value && !std::is_rvalue_reference<T0>::value,
+      "dyno::poly::bind: Only methods and functions whose first parameter is a "
+      "placeholder (other than `dyno::T&&`) can be bound to a poly.");
+    using ErasedSelf = typename detail::erase_placeholder<void, T0>::type;
+    static_assert(std::is_convertible<Self, ErasedSelf>::value,
+      "dyno::poly::bind: Trying to bind a function taking a non-const placeholder "
+      "to a const poly.");
+    ErasedSelf erased = self;
+    return [fptr, erased](auto&& ...args)
+      noexcept(noexcept(fptr(erased, poly::unerase_poly<T>(static_cast<decltype(args)&&>(args))...)))
+      -> decltype(auto)
+    {
+      return fptr(erased, poly::unerase_poly<T>(static_cast<decltype(args)&&>(args))...);
+    };
+  }
+
+  // A batch function bound to a poly is applied to the object held by that
+  // poly alone, i.e. to an array of one object, unless told otherwise.
+  template <typename T0, typename ...T, bool NoExcept, typename FunctionPtr, typename Self>
+  static constexpr auto bind_function(dyno::batch_function_t<void(T0, std::size_t, T...) noexcept(NoExcept)>,
+                                      FunctionPtr fptr, Self self, std::size_t size = 1) {
+    using ErasedSelf = typename detail::erase_placeholder<void, T0>::type;
+    static_assert(std::is_convertible<Self, ErasedSelf>::value,
+      "dyno::poly::bind: Trying to bind a batch function taking a non-const "
+      "placeholder to a const poly.");
+    ErasedSelf erased = self;
+    return [fptr, erased, size](auto&& ...args)
+      noexcept(noexcept(fptr(erased, size, poly::unerase_poly<T>(static_cast<decltype(args)&&>(args))...)))
+      -> void
+    {
+      fptr(erased, size, poly::unerase_poly<T>(static_cast<decltype(args)&&>(args))...);
+    };
+  }
+
+  template <typename R, bool NoExcept, typename FunctionPtr, typename Self>
+  static constexpr void bind_function(dyno::function_t<R() noexcept(NoExcept)>, FunctionPtr, Self) {
+    static_assert(!std::is_same<R, R>::value, // make the assertion dependent
+      "dyno::poly::bind: Only methods and functions whose first parameter is a "
+      "placeholder (other than `dyno::T&&`) can be bound to a poly.");
+  }
+
   // unerase_poly helper
+  //
+  // These don't throw unless a temporary must be created for an argument
+  // passed by value (see `detail::forward_arg`); they are marked `noexcept`
+  // accordingly so that calling a `noexcept` function through `virtual_` or
+  // `bind` is `noexcept` too.
   template <typename T, typename Arg, std::enable_if_t<!detail::is_placeholder<T>::value, int> = 0>
   static constexpr decltype(auto) unerase_poly(Arg&& arg)
-  { return static_cast<Arg&&>(arg); }
+    noexcept(noexcept(detail::forward_arg<T>(static_cast<Arg&&>(arg))))
+  { return detail::forward_arg<T>(static_cast<Arg&&>(arg)); }
 
   template <typename T, typename Arg, std::enable_if_t<detail::is_placeholder<T>::value, int> = 0>
-  static constexpr decltype(auto) unerase_poly(Arg&& arg) {
+  static constexpr decltype(auto) unerase_poly(Arg&& arg) noexcept {
     using RawArg = std::remove_cv_t<std::remove_reference_t<Arg>>;
     constexpr bool is_poly = std::is_same<poly, RawArg>::value;
     static_assert(is_poly,
@@ -245,7 +720,7 @@ private:
     return static_cast<Arg&&>(arg).storage_.get();
   }
   template <typename T, typename Arg, std::enable_if_t<detail::is_placeholder<T>::value, int> = 0>
-  static constexpr decltype(auto) unerase_poly(Arg* arg) {
+  static constexpr decltype(auto) unerase_poly(Arg* arg) noexcept {
     using RawArg = std::remove_cv_t<Arg>;
     constexpr bool is_poly = std::is_same<poly, RawArg>::value;
     static_assert(is_poly,
@@ -255,6 +730,33 @@ private:
   }
 };
 
+// A non-owning reference to an object satisfying the given `Concept`.
+//
+// A `poly_ref` can be constructed from an object satisfying the concept, or
+// from any `dyno::poly` of that concept (or of a concept refining it) with the
+// same vtable policy, regardless of its storage policy. In the latter case, it
+// references the object held by that `poly` and reuses its vtable. Hence, it
+// is suitable for passing type-erased objects to functions without copying.
+// With the default vtable policy, a `poly_ref` is the size of two pointers.
+//
+// The referenced object must outlive the `poly_ref`, and any modification of
+// the `poly` it was created from potentially invalidates the `poly_ref`.
+template <
+  typename Concept,
+  typename VTablePolicy = dyno::vtable<dyno::remote<dyno::everything>>
+>
+using poly_ref = dyno::poly<Concept, dyno::non_owning_storage, VTablePolicy>;
+
+// A non-owning reference to a const object satisfying the given `Concept`.
+//
+// This is like `dyno::poly_ref`, except it can be created from const objects
+// and const `poly`s, and only gives const access to the referenced object.
+template <
+  typename Concept,
+  typename VTablePolicy = dyno::vtable<dyno::remote<dyno::everything>>
+>
+using poly_cref = dyno::poly<Concept, dyno::const_non_owning_storage, VTablePolicy>;
+
 } // end namespace dyno
 
 #endif // DYNO_POLY_HPP
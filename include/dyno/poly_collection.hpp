@@ -0,0 +1,257 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#ifndef DYNO_POLY_COLLECTION_HPP
+#define DYNO_POLY_COLLECTION_HPP
+
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/detail/poly_access.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/vtable.hpp>
+
+#include <cstddef>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+
+namespace dyno {
+
+namespace detail {
+  // A segment of a `poly_collection` is a `std::vector` of objects of some
+  // type, which is erased with this concept.
+  struct Segment : decltype(dyno::requires(
+    dyno::MoveConstructible{},
+    "size"_s = dyno::method<std::size_t () const>,
+    // The constness of the objects is handled by the collection.
+    "data"_s = dyno::method<void* () const>,
+    "clear"_s = dyno::method<void ()>
+  )) { };
+} // end namespace detail
+
+template <typename T>
+auto const concept_map<detail::Segment, std::vector<T>> = dyno::make_concept_map(
+  "size"_s = [](std::vector<T> const& self) { return self.size(); },
+  "data"_s = [](std::vector<T> const& self) -> void* {
+    return const_cast<T*>(self.data());
+  },
+  "clear"_s = [](std::vector<T>& self) { self.clear(); }
+);
+
+// Container of objects of arbitrary types satisfying the given `Concept`,
+// where the objects of each type are stored contiguously in their own segment.
+//
+// Unlike a `std::vector` of `dyno::poly`s, the objects are not allocated one
+// by one, and there is no vtable (or pointer to a vtable) stored along with
+// each object. Instead, each segment holds the vtable of its type, and the
+// objects of the segment are laid out next to each other in memory, exactly
+// like in a `std::vector`. Iterating over the collection then walks through
+// the segments one after the other, which is friendly to the cache and to
+// the branch predictor, since all the objects of a segment use the same
+// functions.
+//
+// The objects are accessed as `dyno::poly_ref`s (or `dyno::poly_cref`s)
+// using the given `VTablePolicy`. The order of the objects is the order of
+// the segments (in order of insertion of their first object), and then the
+// order of insertion within each segment. Inserting an object potentially
+// invalidates references to the other objects of the same type, like for
+// `std::vector`.
+//
+// TODO:
+// - Support copying the collection when all the objects are copyable.
+// - Provide iterators and erasing objects.
+template <
+  typename Concept,
+  typename VTablePolicy = dyno::vtable<dyno::remote<dyno::everything>>
+>
+struct poly_collection {
+  using reference = dyno::poly_ref<Concept, VTablePolicy>;
+  using const_reference = dyno::poly_cref<Concept, VTablePolicy>;
+
+  poly_collection() = default;
+  poly_collection(poly_collection const&) = delete;
+  poly_collection(poly_collection&&) = default;
+  poly_collection& operator=(poly_collection const&) = delete;
+  poly_collection& operator=(poly_collection&&) = default;
+
+  // Inserts the given object at the end of the segment of its type, and
+  // returns a reference to the inserted object.
+  template <typename T, typename RawT = std::decay_t<T>>
+  RawT& insert(T&& object) {
+    return this->emplace<RawT>(std::forward<T>(object));
+  }
+
+  // Constructs an object of type `T` at the end of the segment of its type,
+  // forwarding the arguments to its constructor (or using them to aggregate-
+  // initialize it), and returns a reference to the new object.
+  template <typename T, typename ...Args>
+  T& emplace(Args&& ...args) {
+    static_assert(detail::poly_access::models<reference, T>,
+      "dyno::poly_collection: Trying to insert an object whose type does not "
+      "satisfy the concept of the collection.");
+    std::vector<T>& objects = this->objects<T>(this->segment_for<T>());
+    if constexpr (std::is_constructible<T, Args&&...>::value)
+      objects.emplace_back(std::forward<Args>(args)...);
+    else
+      objects.push_back(T{std::forward<Args>(args)...});
+    return objects.back();
+  }
+
+  // Returns the number of objects in the collection.
+  std::size_t size() const {
+    std::size_t size = 0;
+    for (segment const& s : segments_)
+      size += s.objects.virtual_("size"_s)();
+    return size;
+  }
+
+  // Returns the number of objects of type `T` in the collection.
+  template <typename T>
+  std::size_t size() const {
+    segment const* s = this->find<T>();
+    return s == nullptr ? 0 : s->objects.virtual_("size"_s)();
+  }
+
+  bool empty() const { return this->size() == 0; }
+
+  // Returns the objects of type `T` in the collection, as a contiguous range
+  // delimited by `begin<T>()` and `end<T>()`.
+  template <typename T>
+  T* begin() { return const_cast<T*>(static_cast<poly_collection const&>(*this).begin<T>()); }
+  template <typename T>
+  T* end() { return this->begin<T>() + this->size<T>(); }
+
+  template <typename T>
+  T const* begin() const {
+    segment const* s = this->find<T>();
+    return s == nullptr ? nullptr : static_cast<T const*>(s->objects.virtual_("data"_s)());
+  }
+  template <typename T>
+  T const* end() const { return this->begin<T>() + this->size<T>(); }
+
+  // Destroys all the objects of the collection. The memory held by the
+  // segments is kept for future insertions.
+  void clear() {
+    for (segment& s : segments_)
+      s.objects.virtual_("clear"_s)();
+  }
+
+  // Calls `f` with a reference to each object of the collection, which is
+  // passed as an lvalue.
+  //
+  // When types are specified explicitly, the objects of these types are passed
+  // to `f` as references to their actual type instead, so that `f` can be
+  // inlined for these types. The objects of other types are still passed as
+  // `dyno::poly_ref`s (or `dyno::poly_cref`s).
+  template <typename ...Ts, typename F>
+  void for_each(F&& f) {
+    for (segment& s : segments_)
+      poly_collection::for_each_in<reference, Ts...>(s, f);
+  }
+
+  template <typename ...Ts, typename F>
+  void for_each(F&& f) const {
+    for (segment const& s : segments_)
+      poly_collection::for_each_in<const_reference, Ts const...>(s, f);
+  }
+
+  // Calls the function with the given name on each object of the collection,
+  // with the given arguments, like `dyno::invoke_each`. The function is looked
+  // up once per segment. A `dyno::batch_function` is called once per segment,
+  // with all the objects of the segment.
+  template <typename Function, typename ...Args>
+  void invoke_each(Function name, Args&& ...args) {
+    for (segment& s : segments_)
+      poly_collection::invoke_each_in<reference>(s, name, args...);
+  }
+
+  template <typename Function, typename ...Args>
+  void invoke_each(Function name, Args&& ...args) const {
+    for (segment const& s : segments_)
+      poly_collection::invoke_each_in<const_reference>(s, name, args...);
+  }
+
+private:
+  using VTable = detail::poly_access::vtable_t<reference>;
+
+  struct segment {
+    std::type_info const* type;
+    std::size_t stride;
+    VTable vtable;
+    dyno::poly<detail::Segment> objects;
+  };
+
+  std::vector<segment> segments_;
+
+  template <typename T>
+  segment const* find() const {
+    for (segment const& s : segments_)
+      if (*s.type == typeid(T))
+        return &s;
+    return nullptr;
+  }
+
+  template <typename T>
+  segment& segment_for() {
+    if (segment const* s = this->find<T>())
+      return const_cast<segment&>(*s);
+    segments_.push_back(segment{&typeid(T), sizeof(T),
+                                detail::poly_access::vtable_for<reference, T>(),
+                                dyno::poly<detail::Segment>{std::vector<T>{}}});
+    return segments_.back();
+  }
+
+  template <typename T>
+  static std::vector<T>& objects(segment& s) {
+    return *s.objects.template unsafe_get<std::vector<T>>();
+  }
+
+  template <typename Reference, typename ...Ts, typename Segment, typename F>
+  static void for_each_in(Segment& s, F& f) {
+    char* data = static_cast<char*>(s.objects.virtual_("data"_s)());
+    std::size_t size = s.objects.virtual_("size"_s)();
+    bool restituted = (poly_collection::for_each_as<Ts>(s, data, size, f) || ...);
+    if (!restituted) {
+      for (std::size_t i = 0; i != size; ++i) {
+        Reference object = detail::poly_access::reference<Reference>(s.vtable, data + i * s.stride);
+        f(object);
+      }
+    }
+  }
+
+  template <typename T, typename Segment, typename F>
+  static bool for_each_as(Segment& s, char* data, std::size_t size, F& f) {
+    if (*s.type != typeid(std::remove_const_t<T>))
+      return false;
+    T* first = static_cast<T*>(static_cast<void*>(data));
+    for (T* object = first; object != first + size; ++object)
+      f(*object);
+    return true;
+  }
+
+  template <typename Reference, typename Segment, typename Function, typename ...Args>
+  static void invoke_each_in(Segment& s, Function name, Args& ...args) {
+    char* data = static_cast<char*>(s.objects.virtual_("data"_s)());
+    std::size_t size = s.objects.virtual_("size"_s)();
+    auto fptr = s.vtable[name];
+    if constexpr (detail::poly_access::is_batch<Reference, Function>) {
+      if (size != 0) {
+        Reference first = detail::poly_access::reference<Reference>(s.vtable, data);
+        detail::poly_access::bind_batch(first, name, fptr, size)(args...);
+      }
+    } else {
+      for (std::size_t i = 0; i != size; ++i) {
+        Reference object = detail::poly_access::reference<Reference>(s.vtable, data + i * s.stride);
+        detail::poly_access::bind(object, name, fptr)(args...);
+      }
+    }
+  }
+};
+
+} // end namespace dyno
+
+#endif // DYNO_POLY_COLLECTION_HPP
@@ -0,0 +1,342 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#ifndef DYNO_POLY_SLOT_MAP_HPP
+#define DYNO_POLY_SLOT_MAP_HPP
+
+#include <dyno/builtin.hpp>
+#include <dyno/detail/poly_access.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/storage.hpp>
+#include <dyno/vtable.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace dyno {
+
+// Container of objects of arbitrary types satisfying the given `Concept`,
+// where each object is identified by a `handle` that stays valid until the
+// object is erased, no matter how many other objects are inserted or erased.
+//
+// A handle is made of the 32-bit index of a slot, and the 32-bit generation
+// of that slot, which is incremented whenever the object in the slot is
+// erased. Hence, a handle to an erased object is detected as such, even if
+// its slot was reused for another object since then. Inserting, erasing and
+// finding an object are all O(1), and none of them allocates memory except
+// when the container grows.
+//
+// The objects themselves are stored densely, in a single buffer divided in
+// cells of the same size, which is the size of the largest type inserted so
+// far. The slots only hold the position of their object in the buffer. When
+// an object is erased, the last object is relocated to the cell it leaves
+// empty, so the objects always occupy the beginning of the buffer, and
+// iterating over them walks through contiguous memory. Objects are relocated
+// (when erasing, and when the buffer grows) by copying their bytes when they
+// are trivially relocatable (see `dyno::storage_info`), and with the
+// `"move-construct"` and `"destruct"` functions of their vtable otherwise.
+// Hence, `Concept` must refine `dyno::MoveConstructible`, and the objects must
+// be trivially relocatable or have a move constructor that does not throw, so
+// that erasing an object and growing can't fail half-way.
+//
+// The objects are accessed as `dyno::poly_ref`s (or `dyno::poly_cref`s) using
+// the given `VTablePolicy`, with `operator[]` given a handle, or with the
+// iterators, which visit the objects in the order of the buffer. References
+// to objects are invalidated when objects are inserted or erased.
+//
+// TODO:
+// - Support copying the map when all the objects are copyable.
+// - Support over-aligned types.
+// - Generations wrap around after 2^32 erasures in the same slot, after which
+//   an old handle could refer to a new object.
+template <
+  typename Concept,
+  typename VTablePolicy = dyno::vtable<dyno::remote<dyno::everything>>
+>
+struct poly_slot_map {
+  using reference = dyno::poly_ref<Concept, VTablePolicy>;
+  using const_reference = dyno::poly_cref<Concept, VTablePolicy>;
+
+  // Identifies an object of the map, see above.
+  struct handle {
+    std::uint32_t index;
+    std::uint32_t generation;
+
+    friend bool operator==(handle a, handle b)
+    { return a.index == b.index && a.generation == b.generation; }
+    friend bool operator!=(handle a, handle b)
+    { return !(a == b); }
+  };
+
+private:
+  using VTable = detail::poly_access::vtable_t<reference>;
+
+  static_assert(decltype(std::declval<VTable const&>().contains("move-construct"_s))::value,
+    "dyno::poly_slot_map: The concept of a poly_slot_map must refine "
+    "dyno::MoveConstructible, since the objects are relocated when objects "
+    "are erased and when the map grows.");
+
+  template <typename Reference, typename Map>
+  struct basic_iterator {
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Reference;
+    using reference = Reference;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+
+    Reference operator*() const { return map_->at_position(position_); }
+    basic_iterator& operator++() { ++position_; return *this; }
+    basic_iterator operator++(int) { basic_iterator tmp = *this; ++position_; return tmp; }
+
+    friend bool operator==(basic_iterator const& a, basic_iterator const& b)
+    { return a.position_ == b.position_; }
+    friend bool operator!=(basic_iterator const& a, basic_iterator const& b)
+    { return a.position_ != b.position_; }
+
+  private:
+    friend struct poly_slot_map;
+    basic_iterator(Map* map, std::size_t position)
+      : map_{map}, position_{position}
+    { }
+
+    Map* map_;
+    std::size_t position_;
+  };
+
+public:
+  using iterator = basic_iterator<reference, poly_slot_map>;
+  using const_iterator = basic_iterator<const_reference, poly_slot_map const>;
+
+  poly_slot_map() = default;
+  poly_slot_map(poly_slot_map const&) = delete;
+  poly_slot_map& operator=(poly_slot_map const&) = delete;
+
+  poly_slot_map(poly_slot_map&& other) noexcept
+    : vtables_{std::move(other.vtables_)}
+    , owners_{std::move(other.owners_)}
+    , slots_{std::move(other.slots_)}
+    , free_{std::exchange(other.free_, no_slot)}
+    , data_{std::exchange(other.data_, nullptr)}
+    , stride_{std::exchange(other.stride_, 0)}
+    , alignment_{std::exchange(other.alignment_, 1)}
+    , capacity_{std::exchange(other.capacity_, 0)}
+  {
+    other.vtables_.clear();
+    other.owners_.clear();
+    other.slots_.clear();
+  }
+
+  poly_slot_map& operator=(poly_slot_map&& other) noexcept {
+    poly_slot_map(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  ~poly_slot_map() {
+    this->clear();
+    std::free(data_);
+  }
+
+  void swap(poly_slot_map& other) noexcept {
+    using std::swap;
+    swap(vtables_, other.vtables_);
+    swap(owners_, other.owners_);
+    swap(slots_, other.slots_);
+    swap(free_, other.free_);
+    swap(data_, other.data_);
+    swap(stride_, other.stride_);
+    swap(alignment_, other.alignment_);
+    swap(capacity_, other.capacity_);
+  }
+
+  friend void swap(poly_slot_map& a, poly_slot_map& b) noexcept { a.swap(b); }
+
+  // Inserts the given object in the map, and returns its handle.
+  template <typename T>
+  handle insert(T&& object) {
+    return this->emplace<std::decay_t<T>>(std::forward<T>(object));
+  }
+
+  // Constructs an object of type `T` in the map, forwarding the arguments to
+  // its constructor (or using them to aggregate-initialize it), and returns
+  // the handle of the new object.
+  template <typename T, typename ...Args>
+  handle emplace(Args&& ...args) {
+    static_assert(detail::poly_access::models<reference, T>,
+      "dyno::poly_slot_map: Trying to insert an object whose type does not "
+      "satisfy the concept of the map.");
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+      "dyno::poly_slot_map: Over-aligned types are not supported yet.");
+    static_assert(dyno::storage_info_for<T>.trivially_relocatable ||
+                  dyno::storage_info_for<T>.nothrow_movable,
+      "dyno::poly_slot_map: Trying to insert an object whose move constructor "
+      "may throw, and which is not trivially relocatable. Since the objects are "
+      "relocated when objects are erased and when the map grows, they must be "
+      "movable without throwing. Mark the move constructor `noexcept`, or "
+      "specialize dyno::is_trivially_relocatable for the type if appropriate.");
+    assert(this->size() < no_slot && "dyno::poly_slot_map: Too many objects.");
+
+    std::size_t alignment = std::max(alignment_, alignof(T));
+    std::size_t stride = (std::max(stride_, sizeof(T)) + alignment - 1) / alignment * alignment;
+    if (stride != stride_ || this->size() == capacity_)
+      this->grow(stride, alignment);
+    // Make sure that nothing can throw once the object is constructed.
+    poly_slot_map::reserve_one_more(vtables_);
+    poly_slot_map::reserve_one_more(owners_);
+    if (free_ == no_slot)
+      poly_slot_map::reserve_one_more(slots_);
+
+    std::size_t position = this->size();
+    detail::construct_at<T>(this->object(position), std::forward<Args>(args)...);
+
+    std::uint32_t index = free_;
+    if (index == no_slot) {
+      index = static_cast<std::uint32_t>(slots_.size());
+      slots_.push_back(slot{0, 0});
+    } else {
+      free_ = slots_[index].position;
+    }
+    slots_[index].position = static_cast<std::uint32_t>(position);
+    vtables_.push_back(detail::poly_access::vtable_for<reference, T>());
+    owners_.push_back(index);
+    return handle{index, slots_[index].generation};
+  }
+
+  // Returns whether the given handle refers to an object of the map, i.e.
+  // whether that object was not erased.
+  bool contains(handle h) const {
+    return h.index < slots_.size() && slots_[h.index].generation == h.generation;
+  }
+
+  // Destroys the object with the given handle, if it is in the map, and
+  // returns whether it was. The last object of the buffer is relocated to
+  // the cell of the erased object, which never throws (see `emplace`).
+  bool erase(handle h) {
+    if (!this->contains(h))
+      return false;
+
+    std::size_t position = slots_[h.index].position;
+    std::size_t last = this->size() - 1;
+    vtables_[position]["destruct"_s](this->object(position));
+    if (position != last) {
+      detail::relocate(vtables_[last], this->object(position), this->object(last));
+      vtables_[position] = vtables_[last];
+      owners_[position] = owners_[last];
+      slots_[owners_[position]].position = static_cast<std::uint32_t>(position);
+    }
+    vtables_.pop_back();
+    owners_.pop_back();
+    this->release(h.index);
+    return true;
+  }
+
+  // Destroys all the objects of the map, which invalidates all the handles.
+  // The memory is kept for future insertions.
+  void clear() {
+    while (!this->empty()) {
+      std::size_t last = this->size() - 1;
+      vtables_[last]["destruct"_s](this->object(last));
+      this->release(owners_[last]);
+      vtables_.pop_back();
+      owners_.pop_back();
+    }
+  }
+
+  std::size_t size() const { return vtables_.size(); }
+  bool empty() const { return vtables_.empty(); }
+
+  // Returns the object with the given handle, which must be in the map.
+  reference operator[](handle h) {
+    assert(this->contains(h) && "dyno::poly_slot_map::operator[]: Invalid handle.");
+    return this->at_position(slots_[h.index].position);
+  }
+
+  const_reference operator[](handle h) const {
+    assert(this->contains(h) && "dyno::poly_slot_map::operator[]: Invalid handle.");
+    return this->at_position(slots_[h.index].position);
+  }
+
+  // Returns the handle of the object at the given position in the buffer,
+  // i.e. of the object visited at that position by the iterators.
+  handle handle_at(std::size_t position) const {
+    std::uint32_t index = owners_[position];
+    return handle{index, slots_[index].generation};
+  }
+
+  iterator begin() { return iterator{this, 0}; }
+  iterator end() { return iterator{this, this->size()}; }
+  const_iterator begin() const { return const_iterator{this, 0}; }
+  const_iterator end() const { return const_iterator{this, this->size()}; }
+
+private:
+  static constexpr std::uint32_t no_slot = static_cast<std::uint32_t>(-1);
+
+  // The position of the object of a slot in use, or the next free slot in the
+  // free list otherwise.
+  struct slot {
+    std::uint32_t position;
+    std::uint32_t generation;
+  };
+
+  std::vector<VTable> vtables_;       // the vtable of each object in the buffer
+  std::vector<std::uint32_t> owners_; // the slot of each object in the buffer
+  std::vector<slot> slots_;
+  std::uint32_t free_ = no_slot;
+  char* data_ = nullptr;
+  std::size_t stride_ = 0;
+  std::size_t alignment_ = 1;
+  std::size_t capacity_ = 0;
+
+  void* object(std::size_t position) const { return data_ + position * stride_; }
+
+  reference at_position(std::size_t position) {
+    return detail::poly_access::reference<reference>(vtables_[position], this->object(position));
+  }
+
+  const_reference at_position(std::size_t position) const {
+    return detail::poly_access::reference<const_reference>(vtables_[position], this->object(position));
+  }
+
+  // Invalidates the handles to the given slot, and adds it to the free list.
+  void release(std::uint32_t index) {
+    ++slots_[index].generation;
+    slots_[index].position = free_;
+    free_ = index;
+  }
+
+  template <typename T>
+  static void reserve_one_more(std::vector<T>& v) {
+    if (v.size() == v.capacity())
+      v.reserve(2 * v.size() + 1);
+  }
+
+  // Relocates the objects to a new buffer with room for at least one more
+  // object, whose cells are `stride` bytes long. Relocating the objects never
+  // throws (see `emplace`).
+  void grow(std::size_t stride, std::size_t alignment) {
+    std::size_t capacity = capacity_;
+    if (this->size() == capacity)
+      capacity = std::max<std::size_t>(2 * capacity, 1);
+    char* data = static_cast<char*>(std::malloc(capacity * stride));
+    assert(data != nullptr && "std::malloc failed, we're doomed");
+    for (std::size_t i = 0; i != this->size(); ++i)
+      detail::relocate(vtables_[i], data + i * stride, this->object(i));
+    std::free(data_);
+    data_ = data;
+    stride_ = stride;
+    alignment_ = alignment;
+    capacity_ = capacity;
+  }
+};
+
+} // end namespace dyno
+
+#endif // DYNO_POLY_SLOT_MAP_HPP
@@ -0,0 +1,237 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#ifndef DYNO_POLY_VECTOR_HPP
+#define DYNO_POLY_VECTOR_HPP
+
+#include <dyno/builtin.hpp>
+#include <dyno/detail/poly_access.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/storage.hpp>
+#include <dyno/vtable.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace dyno {
+
+// Sequence of objects of arbitrary types satisfying the given `Concept`, which
+// preserves the order of insertion.
+//
+// The objects are stored next to each other in a single buffer, each at its
+// own size and alignment (as given by `dyno::storage_info`), and the vtables
+// of the objects are stored in a separate array, along with the offset of
+// each object in the buffer. Hence, unlike a `std::vector` of `dyno::poly`s,
+// inserting an object does not allocate memory for that object alone (like
+// `dyno::remote_storage` does), and small objects do not waste the unused
+// bytes of a fixed-size buffer (like `dyno::sbo_storage` does).
+//
+// The objects are accessed as `dyno::poly_ref`s (or `dyno::poly_cref`s) using
+// the given `VTablePolicy`, with `operator[]` or with iterators, which makes
+// a `poly_vector` usable with `dyno::invoke_each`. When the buffer grows, the
+// objects are moved to the new buffer, which invalidates references to them.
+// Hence, `Concept` must refine `dyno::MoveConstructible`, and the objects must
+// be trivially relocatable (see `dyno::is_trivially_relocatable`) or have a
+// move constructor that does not throw, so that growing can't fail half-way.
+//
+// TODO:
+// - Support copying the vector when all the objects are copyable.
+// - Support over-aligned types.
+template <
+  typename Concept,
+  typename VTablePolicy = dyno::vtable<dyno::remote<dyno::everything>>
+>
+struct poly_vector {
+  using reference = dyno::poly_ref<Concept, VTablePolicy>;
+  using const_reference = dyno::poly_cref<Concept, VTablePolicy>;
+
+private:
+  using VTable = detail::poly_access::vtable_t<reference>;
+
+  static_assert(decltype(std::declval<VTable const&>().contains("move-construct"_s))::value,
+    "dyno::poly_vector: The concept of a poly_vector must refine "
+    "dyno::MoveConstructible, since the objects are moved when the vector grows.");
+
+  template <typename Reference, typename Vector>
+  struct basic_iterator {
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Reference;
+    using reference = Reference;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+
+    Reference operator*() const { return (*vector_)[index_]; }
+    basic_iterator& operator++() { ++index_; return *this; }
+    basic_iterator operator++(int) { basic_iterator tmp = *this; ++index_; return tmp; }
+
+    friend bool operator==(basic_iterator const& a, basic_iterator const& b)
+    { return a.index_ == b.index_; }
+    friend bool operator!=(basic_iterator const& a, basic_iterator const& b)
+    { return a.index_ != b.index_; }
+
+  private:
+    friend struct poly_vector;
+    basic_iterator(Vector* vector, std::size_t index)
+      : vector_{vector}, index_{index}
+    { }
+
+    Vector* vector_;
+    std::size_t index_;
+  };
+
+public:
+  using iterator = basic_iterator<reference, poly_vector>;
+  using const_iterator = basic_iterator<const_reference, poly_vector const>;
+
+  poly_vector() = default;
+  poly_vector(poly_vector const&) = delete;
+  poly_vector& operator=(poly_vector const&) = delete;
+
+  poly_vector(poly_vector&& other) noexcept
+    : vtables_{std::move(other.vtables_)}
+    , offsets_{std::move(other.offsets_)}
+    , data_{std::exchange(other.data_, nullptr)}
+    , used_{std::exchange(other.used_, 0)}
+    , capacity_{std::exchange(other.capacity_, 0)}
+  {
+    other.vtables_.clear();
+    other.offsets_.clear();
+  }
+
+  poly_vector& operator=(poly_vector&& other) noexcept {
+    poly_vector(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  ~poly_vector() {
+    this->clear();
+    std::free(data_);
+  }
+
+  void swap(poly_vector& other) noexcept {
+    using std::swap;
+    swap(vtables_, other.vtables_);
+    swap(offsets_, other.offsets_);
+    swap(data_, other.data_);
+    swap(used_, other.used_);
+    swap(capacity_, other.capacity_);
+  }
+
+  friend void swap(poly_vector& a, poly_vector& b) noexcept { a.swap(b); }
+
+  // Inserts the given object at the end of the vector.
+  template <typename T, typename RawT = std::decay_t<T>>
+  RawT& push_back(T&& object) {
+    return this->emplace_back<RawT>(std::forward<T>(object));
+  }
+
+  // Constructs an object of type `T` at the end of the vector, forwarding the
+  // arguments to its constructor (or using them to aggregate-initialize it),
+  // and returns a reference to the new object.
+  template <typename T, typename ...Args>
+  T& emplace_back(Args&& ...args) {
+    static_assert(detail::poly_access::models<reference, T>,
+      "dyno::poly_vector: Trying to insert an object whose type does not "
+      "satisfy the concept of the vector.");
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+      "dyno::poly_vector: Over-aligned types are not supported yet.");
+    static_assert(dyno::storage_info_for<T>.trivially_relocatable ||
+                  dyno::storage_info_for<T>.nothrow_movable,
+      "dyno::poly_vector: Trying to insert an object whose move constructor "
+      "may throw, and which is not trivially relocatable. Since the objects are "
+      "moved when the vector grows, they must be movable without throwing. "
+      "Mark the move constructor `noexcept`, or specialize "
+      "dyno::is_trivially_relocatable for the type if appropriate.");
+
+    std::size_t offset = (used_ + alignof(T) - 1) / alignof(T) * alignof(T);
+    if (offset + sizeof(T) > capacity_)
+      this->grow(offset + sizeof(T));
+    // Make sure that nothing can throw once the object is constructed.
+    poly_vector::reserve_one_more(vtables_);
+    poly_vector::reserve_one_more(offsets_);
+
+    T* object = detail::construct_at<T>(data_ + offset, std::forward<Args>(args)...);
+    vtables_.push_back(detail::poly_access::vtable_for<reference, T>());
+    offsets_.push_back(offset);
+    used_ = offset + sizeof(T);
+    return *object;
+  }
+
+  // Destroys the last object of the vector.
+  void pop_back() {
+    assert(!this->empty() && "dyno::poly_vector::pop_back: The vector is empty.");
+    vtables_.back()["destruct"_s](this->object(vtables_.size() - 1));
+    used_ = offsets_.back();
+    vtables_.pop_back();
+    offsets_.pop_back();
+  }
+
+  // Destroys all the objects of the vector. The memory is kept for future
+  // insertions.
+  void clear() {
+    while (!this->empty())
+      this->pop_back();
+  }
+
+  std::size_t size() const { return vtables_.size(); }
+  bool empty() const { return vtables_.empty(); }
+
+  // Returns the number of bytes used by the objects, including the padding
+  // between them, and the number of bytes that can be used before growing.
+  std::size_t bytes() const { return used_; }
+  std::size_t capacity_bytes() const { return capacity_; }
+
+  reference operator[](std::size_t i) {
+    return detail::poly_access::reference<reference>(vtables_[i], this->object(i));
+  }
+
+  const_reference operator[](std::size_t i) const {
+    return detail::poly_access::reference<const_reference>(vtables_[i], this->object(i));
+  }
+
+  iterator begin() { return iterator{this, 0}; }
+  iterator end() { return iterator{this, this->size()}; }
+  const_iterator begin() const { return const_iterator{this, 0}; }
+  const_iterator end() const { return const_iterator{this, this->size()}; }
+
+private:
+  std::vector<VTable> vtables_;
+  std::vector<std::size_t> offsets_;
+  char* data_ = nullptr;
+  std::size_t used_ = 0;
+  std::size_t capacity_ = 0;
+
+  void* object(std::size_t i) const { return data_ + offsets_[i]; }
+
+  template <typename T>
+  static void reserve_one_more(std::vector<T>& v) {
+    if (v.size() == v.capacity())
+      v.reserve(2 * v.size() + 1);
+  }
+
+  // Moves the objects to a new buffer of at least `capacity` bytes. Since both
+  // buffers are suitably aligned for any type, the objects keep their offset.
+  // Relocating the objects never throws (see `emplace_back`).
+  void grow(std::size_t capacity) {
+    if (capacity < 2 * capacity_)
+      capacity = 2 * capacity_;
+    char* data = static_cast<char*>(std::malloc(capacity));
+    assert(data != nullptr && "std::malloc failed, we're doomed");
+    for (std::size_t i = 0; i != this->size(); ++i)
+      detail::relocate(vtables_[i], data + offsets_[i], this->object(i));
+    std::free(data_);
+    data_ = data;
+    capacity_ = capacity;
+  }
+};
+
+} // end namespace dyno
+
+#endif // DYNO_POLY_VECTOR_HPP
@@ -0,0 +1,263 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#ifndef DYNO_RECLAIMER_HPP
+#define DYNO_RECLAIMER_HPP
+
+#include <dyno/builtin.hpp>
+#include <dyno/storage.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace dyno {
+
+// Queue of objects allocated on the heap whose destruction was deferred, so
+// that the cost of running their destructor and freeing their memory is not
+// paid where they are released.
+//
+// The retired objects are destroyed either when `reclaim()` is called, which
+// is meant to be done at a quiescent point (e.g. between two frames or two
+// requests), or continuously by a background thread started with
+// `start_background_thread()`. Retiring objects and reclaiming them is
+// thread-safe. When the background thread is used, the destructors of the
+// objects run on that thread, so they must not depend on the thread where the
+// object was released. Any object still in the queue is destroyed when the
+// reclaimer is destroyed.
+//
+// Retiring an object never throws: if the object can't be queued (e.g. when
+// growing the queue fails to allocate memory), it is destroyed right away.
+//
+// TODO:
+// - Consider a lock-free queue, if the lock ever becomes contended.
+class reclaimer {
+public:
+  reclaimer() = default;
+  reclaimer(reclaimer const&) = delete;
+  reclaimer& operator=(reclaimer const&) = delete;
+
+  ~reclaimer() {
+    this->stop_background_thread();
+    this->reclaim();
+  }
+
+  // Hands an object allocated with `std::malloc` to the reclaimer, which will
+  // destroy it with the `"destroy"` function of the vtable if it provides one,
+  // and with the `"destruct"` function followed by `std::free` otherwise. The
+  // functions are retrieved right away, so the vtable may be destroyed.
+  template <typename VTable>
+  void retire(VTable const& vtable, void* ptr) noexcept {
+    garbage g{nullptr, nullptr, ptr};
+    if constexpr (decltype(vtable.contains("destroy"_s))::value)
+      g.destroy = vtable["destroy"_s];
+    else
+      g.destruct = vtable["destruct"_s];
+
+    bool was_empty;
+    try {
+      std::lock_guard<std::mutex> lock{mutex_};
+      was_empty = queue_.empty();
+      queue_.push_back(g);
+    } catch (...) {
+      reclaimer::dispose(g);
+      return;
+    }
+    if (was_empty)
+      ready_.notify_one();
+  }
+
+  // Destroys all the objects retired so far on the calling thread, and
+  // returns how many objects were destroyed.
+  std::size_t reclaim() {
+    std::vector<garbage> batch;
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      batch.swap(queue_);
+    }
+    for (garbage const& g : batch)
+      reclaimer::dispose(g);
+    return batch.size();
+  }
+
+  // Returns the number of objects retired but not destroyed yet.
+  std::size_t pending() const {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return queue_.size();
+  }
+
+  // Starts a thread destroying the objects as they are retired, if it is not
+  // running already.
+  void start_background_thread() {
+    if (!thread_.joinable())
+      thread_ = std::thread{[this] { this->run(); }};
+  }
+
+  // Waits until the background thread destroyed all the objects retired so
+  // far, and stops it. Does nothing if the thread is not running.
+  void stop_background_thread() {
+    if (!thread_.joinable())
+      return;
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      stopping_ = true;
+    }
+    ready_.notify_one();
+    thread_.join();
+    stopping_ = false;
+  }
+
+private:
+  struct garbage {
+    void (*destroy)(void*);
+    void (*destruct)(void*);
+    void* ptr;
+  };
+
+  static void dispose(garbage const& g) {
+    if (g.destroy != nullptr) {
+      g.destroy(g.ptr);
+    } else {
+      g.destruct(g.ptr);
+      std::free(g.ptr);
+    }
+  }
+
+  // Destroys the objects in batches, alternating between two buffers so that
+  // the queue keeps its capacity. The queue is drained before stopping.
+  void run() {
+    std::vector<garbage> batch;
+    std::unique_lock<std::mutex> lock{mutex_};
+    while (true) {
+      ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      if (queue_.empty())
+        return;
+      batch.swap(queue_);
+      lock.unlock();
+      for (garbage const& g : batch)
+        reclaimer::dispose(g);
+      batch.clear();
+      lock.lock();
+    }
+  }
+
+  mutable std::mutex mutex_;
+  std::condition_variable ready_;
+  std::vector<garbage> queue_;
+  std::thread thread_;
+  bool stopping_ = false;
+};
+
+// Class implementing storage on the heap, like `dyno::remote_storage`, except
+// that destructing the storage hands its object to a `dyno::reclaimer` shared
+// by all the `deferred_storage`s with the same `Tag`, instead of destroying it
+// right away. This moves the cost of destroying large objects (e.g. objects
+// owning a large graph) off the hot path.
+//
+// Objects that are trivially destructible (see `dyno::storage_info`) are
+// still destroyed right away, since the only cost is freeing their memory.
+// The retired objects are destroyed as explained for `dyno::reclaimer`, e.g.
+// with `deferred_storage<Tag>::shared_reclaimer().reclaim()`.
+//
+// This header is not included by `dyno.hpp`, since the reclaimer uses a
+// thread; link with the `Dyno::parallel` CMake target to use it.
+//
+// TODO:
+// - Provide `reset`, retiring the old object instead of reusing its memory.
+template <typename Tag = void>
+struct deferred_storage {
+  deferred_storage() = delete;
+  deferred_storage(deferred_storage const&) = delete;
+  deferred_storage(deferred_storage&&) = delete;
+  deferred_storage& operator=(deferred_storage&&) = delete;
+  deferred_storage& operator=(deferred_storage const&) = delete;
+
+  // Returns the reclaimer shared by the storages with the same `Tag`.
+  static dyno::reclaimer& shared_reclaimer() {
+    static dyno::reclaimer reclaimer;
+    return reclaimer;
+  }
+
+  // The shared reclaimer is created before the first object (see
+  // `with_shared_reclaimer`), so that it is destroyed after all the storages
+  // using it, including the ones with static storage duration. Copies and
+  // moves have a source that already created it.
+  template <typename T, typename RawT = std::decay_t<T>>
+  explicit deferred_storage(T&& t)
+    : storage_{with_shared_reclaimer(std::in_place_type<RawT>), std::forward<T>(t)}
+  { }
+
+  template <typename T, typename ...Args>
+  explicit deferred_storage(std::in_place_type_t<T>, Args&& ...args)
+    : storage_{with_shared_reclaimer(std::in_place_type<T>), std::forward<Args>(args)...}
+  { }
+
+  template <typename VTable, typename Construct>
+  deferred_storage(dyno::in_place_construct_t, VTable const& vtable, Construct&& construct)
+    : storage_{with_shared_reclaimer(dyno::in_place_construct), vtable, construct}
+  { }
+
+  template <typename VTable>
+  deferred_storage(deferred_storage const& other, VTable const& vtable)
+    : storage_{other.storage_, vtable}
+  { }
+
+  template <typename VTable>
+  deferred_storage(deferred_storage&& other, VTable const& vtable) noexcept
+    : storage_{std::move(other.storage_), vtable}
+  { }
+
+  template <typename MyVTable, typename OtherVTable>
+  void swap(MyVTable const& this_vtable, deferred_storage& other, OtherVTable const& other_vtable) {
+    storage_.swap(this_vtable, other.storage_, other_vtable);
+  }
+
+  template <typename VTable>
+  void destruct(VTable const& vtable) {
+    // If we've been moved from, don't do anything.
+    void* ptr = storage_.get();
+    if (ptr == nullptr)
+      return;
+
+    if (vtable["storage_info"_s].trivially_destructible)
+      storage_.destruct(vtable);
+    else
+      shared_reclaimer().retire(vtable, ptr);
+  }
+
+  template <typename T = void>
+  T* get() {
+    return storage_.template get<T>();
+  }
+
+  template <typename T = void>
+  T const* get() const {
+    return storage_.template get<T>();
+  }
+
+  static constexpr bool can_store(dyno::storage_info info) {
+    return dyno::remote_storage::can_store(info);
+  }
+
+private:
+  // Creates the shared reclaimer if it does not exist yet, and returns the
+  // given tag, which is passed to the constructor of the underlying storage.
+  template <typename InPlaceTag>
+  static InPlaceTag with_shared_reclaimer(InPlaceTag tag) {
+    shared_reclaimer();
+    return tag;
+  }
+
+  dyno::remote_storage storage_;
+};
+
+} // end namespace dyno
+
+#endif // DYNO_RECLAIMER_HPP
@@ -11,7 +11,9 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdlib>
+#include <cstring>
 #include <memory>
+#include <new>
 #include <type_traits>
 #include <utility>
 
@@ -41,6 +43,13 @@ namespace dyno {
 //             could be too large to fit in a predefined buffer size, in which
 //             case this call would not compile.
 //
+// template <typename T, typename ...Args> explicit Storage(std::in_place_type_t<T>, Args&&...);
+//  Semantics: Construct an object of type `T` in the polymorphic storage,
+//             forwarding the arguments to its constructor (or using them to
+//             aggregate-initialize it). No temporary object is created, so
+//             this works for types that are not movable. Storages that do
+//             not own the object they hold do not provide this constructor.
+//
 // template <typename VTable> Storage(Storage const&, VTable const&);
 //  Semantics: Copy-construct the contents of the polymorphic storage,
 //             assuming the contents of the source storage can be
@@ -49,7 +58,9 @@ namespace dyno {
 // template <typename VTable> Storage(Storage&&, VTable const&);
 //  Semantics: Move-construct the contents of the polymorphic storage,
 //             assuming the contents of the source storage can be
-//             manipulated using the provided vtable.
+//             manipulated using the provided vtable. This should be
+//             `noexcept` whenever possible, since `dyno::poly`'s move
+//             constructor is `noexcept` exactly when this is.
 //
 // template <typename MyVTable, typename OtherVTable>
 // void swap(MyVTable const&, Storage&, OtherVTable const&);
@@ -87,11 +98,165 @@ namespace dyno {
 // static constexpr bool can_store(dyno::storage_info);
 //  Semantics: Return whether the polymorphic storage can store an object with
 //             the specified type information.
+//
+// Optionally, a `Storage` may also be constructible from other kinds of
+// polymorphic storage:
+//
+// template <typename OtherStorage, typename VTable> Storage(OtherStorage&&, VTable const&);
+//  Semantics: Construct the contents of the polymorphic storage from the
+//             contents of another polymorphic storage of a different type,
+//             assuming the contents of the source storage can be manipulated
+//             using the provided vtable. This is what `dyno::poly` uses when
+//             converting between `poly`s with different storage policies.
+//
+// template <typename VTable, typename Construct>
+// Storage(dyno::in_place_construct_t, VTable const&, Construct&&);
+//  Semantics: Allocate memory for an object with the type information
+//             `vtable["storage_info"_s]`, and call `construct` with a `void*`
+//             to that memory, which must construct such an object at that
+//             address. If `construct` throws, the memory is released and the
+//             exception is propagated. This is what `dyno::poly` uses for
+//             functions returning `dyno::T` by value, which construct their
+//             result directly inside the storage of the resulting `poly`.
+//
+// template <typename VTable> void* reset(VTable const&, dyno::storage_info);
+//  Semantics: Destruct the object held inside the polymorphic storage like
+//             `destruct`, assuming that object can be manipulated using the
+//             provided vtable, and return a pointer to uninitialized memory
+//             owned by the storage, where an object with the specified type
+//             information can be constructed. Resources held by the storage
+//             (e.g. a heap allocation) should be reused whenever possible.
+//             The caller must construct an object at the returned address
+//             before the storage is used again. This is what `dyno::poly`
+//             uses for copy-assignment and `emplace`, when available.
+
+// Tag used to construct a polymorphic storage whose object is constructed by
+// a function, see the documentation of the `PolymorphicStorage` concept.
+struct in_place_construct_t { };
+constexpr in_place_construct_t in_place_construct{};
+
+namespace detail {
+  // Constructs an object of type `T` at the given address. Aggregates, which
+  // can't be initialized with parentheses, are initialized with braces.
+  template <typename T, typename ...Args>
+  T* construct_at(void* where, Args&& ...args) {
+    if constexpr (std::is_constructible<T, Args&&...>::value)
+      return new (where) T(std::forward<Args>(args)...);
+    else
+      return new (where) T{std::forward<Args>(args)...};
+  }
+
+  // Whether `construct_at<T>` can be called with the given arguments without
+  // throwing.
+  template <typename T, typename ...Args>
+  constexpr bool is_nothrow_constructible_at() {
+    if constexpr (std::is_constructible<T, Args&&...>::value)
+      return std::is_nothrow_constructible<T, Args&&...>::value;
+    else
+      return noexcept(T{std::declval<Args>()...});
+  }
+
+  // Object allocated by `dyno::shared_remote_storage`, which constructs the
+  // actual object in place. The address of the box is the address of the
+  // object it holds.
+  template <typename T>
+  struct shared_box {
+    template <typename ...Args>
+    explicit shared_box(Args&& ...args)
+    { detail::construct_at<T>(&storage_, std::forward<Args>(args)...); }
+
+    shared_box(shared_box const&) = delete;
+    shared_box& operator=(shared_box const&) = delete;
+
+    ~shared_box() { static_cast<T*>(static_cast<void*>(&storage_))->~T(); }
+
+  private:
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage_;
+  };
+
+  // Allocates memory for an object with the given type information on the
+  // heap, and constructs the object with `construct` like explained for the
+  // `dyno::in_place_construct` constructor of storages. The memory is freed
+  // if `construct` throws.
+  template <typename Construct>
+  void* construct_on_heap(dyno::storage_info info, Construct& construct) {
+    struct free_on_exit {
+      void* ptr;
+      ~free_on_exit() { std::free(ptr); }
+    } guard{std::malloc(info.size)};
+    // TODO: That's not a really nice way to handle this
+    assert(guard.ptr != nullptr && "std::malloc failed, we're doomed");
+    construct(guard.ptr);
+    void* ptr = guard.ptr;
+    guard.ptr = nullptr;
+    return ptr;
+  }
+
+  // Allocates a copy of the object held by the given storage on the heap,
+  // using the `"clone"` function of the vtable if it provides one.
+  template <typename VTable, typename Storage>
+  void* clone_on_heap(VTable const& vtable, Storage const& other) {
+    if constexpr (decltype(vtable.contains("clone"_s))::value) {
+      return vtable["clone"_s](other.get());
+    } else {
+      auto copy = [&](void* where) { vtable["copy-construct"_s](where, other.get()); };
+      return detail::construct_on_heap(vtable["storage_info"_s], copy);
+    }
+  }
+
+  // Destructs the object at the given address and frees its memory, using
+  // the `"destroy"` function of the vtable if it provides one.
+  template <typename VTable>
+  void destroy_on_heap(VTable const& vtable, void* ptr) {
+    if constexpr (decltype(vtable.contains("destroy"_s))::value) {
+      vtable["destroy"_s](ptr);
+    } else {
+      vtable["destruct"_s](ptr);
+      std::free(ptr);
+    }
+  }
+
+  // Moves the object at `from` to the uninitialized memory at `to`, and ends
+  // the lifetime of the object at `from`. Objects that are trivially
+  // relocatable are simply copied byte by byte, and the others are moved with
+  // the `"move-construct"` function of the vtable, and then destructed.
+  template <typename VTable>
+  void relocate(VTable const& vtable, void* to, void* from) {
+    dyno::storage_info info = vtable["storage_info"_s];
+    if (info.trivially_relocatable) {
+      std::memcpy(to, from, info.size);
+    } else {
+      vtable["move-construct"_s](to, from);
+      vtable["destruct"_s](from);
+    }
+  }
+
+  // Swaps the objects at the given addresses using the `"swap"` function of
+  // the vtables, when they provide one (and it is not null) and they are known
+  // to be used with objects of the same type. Returns whether the objects were swapped.
+  template <typename MyVTable, typename OtherVTable>
+  bool try_swap_same_type(MyVTable const& this_vtable, void* a,
+                          OtherVTable const& other_vtable, void* b) {
+    if constexpr (std::is_same<MyVTable, OtherVTable>::value &&
+                  decltype(this_vtable.contains("swap"_s))::value) {
+      auto swap = this_vtable["swap"_s];
+      if (swap != nullptr && this_vtable.same_concept_map(other_vtable)) {
+        swap(a, b);
+        return true;
+      }
+    }
+    return false;
+  }
+} // end namespace detail
+
+struct remote_storage;
 
 // Class implementing the small buffer optimization (SBO).
 //
 // This class represents a value of an unknown type that is stored either on
 // the heap, or on the stack if it fits in the specific small buffer size.
+// Objects whose move constructor may throw are always stored on the heap,
+// which makes moving a `sbo_storage` `noexcept`, like for `std::any`.
 //
 // TODO: - Consider having ptr_ always point to either sb_ or the heap.
 //       - Alternatively, if we had a way to access the vtable here, we could
@@ -119,37 +284,47 @@ public:
   sbo_storage& operator=(sbo_storage const&) = delete;
 
   static constexpr bool can_store(dyno::storage_info info) {
-    return info.size <= sizeof(SBStorage) && alignof(SBStorage) % info.alignment == 0;
+    return info.size <= sizeof(SBStorage) && alignof(SBStorage) % info.alignment == 0 &&
+           info.nothrow_movable;
   }
 
   template <typename T, typename RawT = std::decay_t<T>>
-  explicit sbo_storage(T&& t) {
+  explicit sbo_storage(T&& t)
+    : sbo_storage{std::in_place_type<RawT>, std::forward<T>(t)}
+  { }
+
+  template <typename T, typename ...Args>
+  explicit sbo_storage(std::in_place_type_t<T>, Args&& ...args) {
     // TODO: We could also construct the object at an aligned address within
     // the buffer, which would require computing the right address everytime
     // we access the buffer as a T, but would allow more Ts to fit in the SBO.
-    if constexpr (can_store(dyno::storage_info_for<RawT>)) {
+    if constexpr (can_store(dyno::storage_info_for<T>)) {
       uses_heap_ = false;
-      new (&sb_) RawT(std::forward<T>(t));
+      detail::construct_at<T>(&sb_, std::forward<Args>(args)...);
     } else {
       uses_heap_ = true;
-      ptr_ = std::malloc(sizeof(RawT));
-      // TODO: Allocating and then calling the constructor is not
-      //       exception-safe if the constructor throws.
-      // TODO: That's not a really nice way to handle this
-      assert(ptr_ != nullptr && "std::malloc failed, we're doomed");
-      new (ptr_) RawT(std::forward<T>(t));
+      auto construct = [&](void* where) { detail::construct_at<T>(where, std::forward<Args>(args)...); };
+      ptr_ = detail::construct_on_heap(dyno::storage_info_for<T>, construct);
+    }
+  }
+
+  template <typename VTable, typename Construct>
+  sbo_storage(dyno::in_place_construct_t, VTable const& vtable, Construct&& construct) {
+    dyno::storage_info info = vtable["storage_info"_s];
+    if (can_store(info)) {
+      uses_heap_ = false;
+      construct(static_cast<void*>(&sb_));
+    } else {
+      uses_heap_ = true;
+      ptr_ = detail::construct_on_heap(info, construct);
     }
   }
 
   template <typename VTable>
   sbo_storage(sbo_storage const& other, VTable const& vtable) {
     if (other.uses_heap()) {
-      auto info = vtable["storage_info"_s]();
       uses_heap_ = true;
-      ptr_ = std::malloc(info.size);
-      // TODO: That's not a really nice way to handle this
-      assert(ptr_ != nullptr && "std::malloc failed, we're doomed");
-      vtable["copy-construct"_s](ptr_, other.get());
+      ptr_ = detail::clone_on_heap(vtable, other);
     } else {
       uses_heap_ = false;
       vtable["copy-construct"_s](&sb_, other.get());
@@ -157,7 +332,7 @@ public:
   }
 
   template <typename VTable>
-  sbo_storage(sbo_storage&& other, VTable const& vtable)
+  sbo_storage(sbo_storage&& other, VTable const& vtable) noexcept
     : uses_heap_{other.uses_heap()}
   {
     if (uses_heap()) {
@@ -168,6 +343,38 @@ public:
     }
   }
 
+  // Move-construct from a `sbo_storage` with a different buffer. If the other
+  // object is on the heap, its allocation is stolen. Otherwise, the object is
+  // moved to our buffer if it fits, and to the heap otherwise.
+  template <std::size_t OtherSize, std::size_t OtherAlign, typename VTable>
+  sbo_storage(sbo_storage<OtherSize, OtherAlign>&& other, VTable const& vtable) {
+    if (other.uses_heap()) {
+      uses_heap_ = true;
+      ptr_ = other.ptr_;
+      other.ptr_ = nullptr;
+    } else if (can_store(vtable["storage_info"_s])) {
+      uses_heap_ = false;
+      vtable["move-construct"_s](&sb_, other.get());
+    } else {
+      uses_heap_ = true;
+      ptr_ = std::malloc(vtable["storage_info"_s].size);
+      // TODO: That's not a really nice way to handle this
+      assert(ptr_ != nullptr && "std::malloc failed, we're doomed");
+      vtable["move-construct"_s](ptr_, other.get());
+    }
+  }
+
+  // Move-construct from a `remote_storage`, stealing its allocation. Both
+  // storages allocate with `std::malloc`, so the object can stay where it is,
+  // even if it would fit in our buffer.
+  template <typename Remote, typename VTable,
+            typename = std::enable_if_t<std::is_same<Remote, remote_storage>::value>>
+  sbo_storage(Remote&& other, VTable const&) noexcept
+    : ptr_{other.ptr_}, uses_heap_{true}
+  {
+    other.ptr_ = nullptr;
+  }
+
   template <typename MyVTable, typename OtherVTable>
   void swap(MyVTable const& this_vtable, sbo_storage& other, OtherVTable const& other_vtable) {
     if (this == &other)
@@ -203,20 +410,47 @@ public:
         this->uses_heap_ = true;
 
       } else {
-        // Move `other` into temporary local storage, destructively.
-        SBStorage tmp;
-        other_vtable["move-construct"_s](&tmp, &other.sb_);
-        other_vtable["destruct"_s](&other.sb_);
+        this->swap_buffers(this_vtable, other, other_vtable);
+      }
+    }
+  }
 
-        // Move `*this` into `other`, destructively.
-        this_vtable["move-construct"_s](&other.sb_, &this->sb_);
-        this_vtable["destruct"_s](&this->sb_);
+  // The object is put in the buffer whenever it fits. Otherwise, the current
+  // heap allocation is reused if it is large enough for the new object.
+  //
+  // TODO: We only know the size of the object currently on the heap, not the
+  //       size of the allocation, so the allocation can only shrink over time.
+  template <typename VTable>
+  void* reset(VTable const& vtable, dyno::storage_info info) {
+    if (uses_heap()) {
+      std::size_t capacity = 0;
+      // If we've been moved from, there's nothing to destruct or reuse.
+      if (ptr_ != nullptr)
+        capacity = vtable["storage_info"_s].size;
+
+      if (!can_store(info) && info.size <= capacity) {
+        vtable["destruct"_s](ptr_);
+        return ptr_;
+      }
 
-        // Now, bring `tmp` into `*this`, destructively.
-        other_vtable["move-construct"_s](&this->sb_, &tmp);
-        other_vtable["destruct"_s](&tmp);
+      if (ptr_ != nullptr)
+        detail::destroy_on_heap(vtable, ptr_);
+
+      if (can_store(info)) {
+        uses_heap_ = false;
+        return &sb_;
       }
+    } else {
+      vtable["destruct"_s](&sb_);
+      if (can_store(info))
+        return &sb_;
     }
+
+    uses_heap_ = true;
+    ptr_ = std::malloc(info.size);
+    // TODO: That's not a really nice way to handle this
+    assert(ptr_ != nullptr && "std::malloc failed, we're doomed");
+    return ptr_;
   }
 
   template <typename VTable>
@@ -226,8 +460,7 @@ public:
       if (ptr_ == nullptr)
         return;
 
-      vtable["destruct"_s](ptr_);
-      std::free(ptr_);
+      detail::destroy_on_heap(vtable, ptr_);
     } else {
       vtable["destruct"_s](&sb_);
     }
@@ -244,7 +477,33 @@ public:
   }
 
 private:
+  template <std::size_t, std::size_t>
+  friend class sbo_storage;
+  friend struct remote_storage;
+
   bool uses_heap() const { return uses_heap_; }
+
+  // Swaps the contents of the buffers, when both objects are in the buffers.
+  // This is kept out of `swap` so that the cheap case where both objects are
+  // on the heap can be inlined.
+  template <typename MyVTable, typename OtherVTable>
+  void swap_buffers(MyVTable const& this_vtable, sbo_storage& other, OtherVTable const& other_vtable) {
+    if (detail::try_swap_same_type(this_vtable, &this->sb_, other_vtable, &other.sb_))
+      return;
+
+    // Move `other` into temporary local storage, destructively.
+    SBStorage tmp;
+    other_vtable["move-construct"_s](&tmp, &other.sb_);
+    other_vtable["destruct"_s](&other.sb_);
+
+    // Move `*this` into `other`, destructively.
+    this_vtable["move-construct"_s](&other.sb_, &this->sb_);
+    this_vtable["destruct"_s](&this->sb_);
+
+    // Now, bring `tmp` into `*this`, destructively.
+    other_vtable["move-construct"_s](&this->sb_, &tmp);
+    other_vtable["destruct"_s](&tmp);
+  }
 };
 
 // Class implementing storage on the heap. Just like the `sbo_storage`, it
@@ -259,44 +518,81 @@ struct remote_storage {
 
   template <typename T, typename RawT = std::decay_t<T>>
   explicit remote_storage(T&& t)
-    : ptr_{std::malloc(sizeof(RawT))}
-  {
-    // TODO: That's not a really nice way to handle this
-    assert(ptr_ != nullptr && "std::malloc failed, we're doomed");
+    : remote_storage{std::in_place_type<RawT>, std::forward<T>(t)}
+  { }
 
-    new (ptr_) RawT(std::forward<T>(t));
+  template <typename T, typename ...Args>
+  explicit remote_storage(std::in_place_type_t<T>, Args&& ...args) {
+    auto construct = [&](void* where) { detail::construct_at<T>(where, std::forward<Args>(args)...); };
+    ptr_ = detail::construct_on_heap(dyno::storage_info_for<T>, construct);
   }
 
+  template <typename VTable, typename Construct>
+  remote_storage(dyno::in_place_construct_t, VTable const& vtable, Construct&& construct)
+    : ptr_{detail::construct_on_heap(vtable["storage_info"_s], construct)}
+  { }
+
   template <typename VTable>
   remote_storage(remote_storage const& other, VTable const& vtable)
-    : ptr_{std::malloc(vtable["storage_info"_s]().size)}
-  {
-    // TODO: That's not a really nice way to handle this
-    assert(ptr_ != nullptr && "std::malloc failed, we're doomed");
-
-    vtable["copy-construct"_s](this->get(), other.get());
-  }
+    : ptr_{detail::clone_on_heap(vtable, other)}
+  { }
 
   template <typename VTable>
-  remote_storage(remote_storage&& other, VTable const&)
+  remote_storage(remote_storage&& other, VTable const&) noexcept
     : ptr_{other.ptr_}
   {
     other.ptr_ = nullptr;
   }
 
+  // Move-construct from a `sbo_storage`. If the other object is on the heap,
+  // its allocation is stolen, since both storages allocate with `std::malloc`.
+  // Otherwise, the object is moved to a new allocation.
+  template <std::size_t Size, std::size_t Align, typename VTable>
+  remote_storage(sbo_storage<Size, Align>&& other, VTable const& vtable) {
+    if (other.uses_heap()) {
+      ptr_ = other.ptr_;
+      other.ptr_ = nullptr;
+    } else {
+      ptr_ = std::malloc(vtable["storage_info"_s].size);
+      // TODO: That's not a really nice way to handle this
+      assert(ptr_ != nullptr && "std::malloc failed, we're doomed");
+      vtable["move-construct"_s](ptr_, other.get());
+    }
+  }
+
   template <typename MyVTable, typename OtherVTable>
   void swap(MyVTable const&, remote_storage& other, OtherVTable const&) {
     std::swap(this->ptr_, other.ptr_);
   }
 
+  // The current allocation is reused if it is large enough for the new object.
+  //
+  // TODO: We only know the size of the object currently held, not the size
+  //       of the allocation, so the allocation can only shrink over time.
+  template <typename VTable>
+  void* reset(VTable const& vtable, dyno::storage_info info) {
+    // If we've been moved from, there's nothing to destruct or reuse.
+    if (ptr_ != nullptr) {
+      if (info.size <= vtable["storage_info"_s].size) {
+        vtable["destruct"_s](ptr_);
+        return ptr_;
+      }
+      detail::destroy_on_heap(vtable, ptr_);
+    }
+
+    ptr_ = std::malloc(info.size);
+    // TODO: That's not a really nice way to handle this
+    assert(ptr_ != nullptr && "std::malloc failed, we're doomed");
+    return ptr_;
+  }
+
   template <typename VTable>
   void destruct(VTable const& vtable) {
     // If we've been moved from, don't do anything.
     if (ptr_ == nullptr)
       return;
 
-    vtable["destruct"_s](ptr_);
-    std::free(ptr_);
+    detail::destroy_on_heap(vtable, ptr_);
   }
 
   template <typename T = void>
@@ -314,6 +610,9 @@ struct remote_storage {
   }
 
 private:
+  template <std::size_t, std::size_t>
+  friend class sbo_storage;
+
   void* ptr_;
 };
 
@@ -340,13 +639,29 @@ struct shared_remote_storage {
     : ptr_{std::make_shared<RawT>(std::forward<T>(t))}
   { }
 
+  template <typename T, typename ...Args>
+  explicit shared_remote_storage(std::in_place_type_t<T>, Args&& ...args)
+    : ptr_{std::make_shared<detail::shared_box<T>>(std::forward<Args>(args)...)}
+  { }
+
+  // The object is allocated like in `remote_storage`, so it is destructed and
+  // freed explicitly when the last reference goes away.
+  template <typename VTable, typename Construct>
+  shared_remote_storage(dyno::in_place_construct_t, VTable const& vtable, Construct&& construct)
+    : ptr_{detail::construct_on_heap(vtable["storage_info"_s], construct),
+           [destruct = vtable["destruct"_s]](void* ptr) {
+             destruct(ptr);
+             std::free(ptr);
+           }}
+  { }
+
   template <typename VTable>
   shared_remote_storage(shared_remote_storage const& other, VTable const&)
     : ptr_{other.ptr_}
   { }
 
   template <typename VTable>
-  shared_remote_storage(shared_remote_storage&& other, VTable const&)
+  shared_remote_storage(shared_remote_storage&& other, VTable const&) noexcept
     : ptr_{std::move(other.ptr_)}
   { }
 
@@ -384,7 +699,8 @@ private:
 // This is like a small buffer optimization, except the behavior is undefined
 // when the object can't fit inside the buffer. Since we know the object always
 // sits inside the local buffer, we can get rid of a branch when accessing the
-// object.
+// object. However, this also means that the object itself must be moved when
+// the storage is moved, so moving a `local_storage` is not `noexcept`.
 template <std::size_t Size, std::size_t Align = static_cast<std::size_t>(-1)>
 class local_storage {
   static constexpr std::size_t SBAlign = Align == static_cast<std::size_t>(-1)
@@ -405,20 +721,34 @@ public:
   }
 
   template <typename T, typename RawT = std::decay_t<T>>
-  explicit local_storage(T&& t) {
+  explicit local_storage(T&& t)
+    : local_storage{std::in_place_type<RawT>, std::forward<T>(t)}
+  { }
+
+  template <typename T, typename ...Args>
+  explicit local_storage(std::in_place_type_t<T>, Args&& ...args) {
     // TODO: We could also construct the object at an aligned address within
     // the buffer, which would require computing the right address everytime
     // we access the buffer as a T, but would allow more Ts to fit inside it.
-    static_assert(can_store(dyno::storage_info_for<RawT>),
+    static_assert(can_store(dyno::storage_info_for<T>),
       "dyno::local_storage: Trying to construct from an object that won't fit "
       "in the local storage.");
 
-    new (&buffer_) RawT(std::forward<T>(t));
+    detail::construct_at<T>(&buffer_, std::forward<Args>(args)...);
+  }
+
+  template <typename VTable, typename Construct>
+  local_storage(dyno::in_place_construct_t, VTable const& vtable, Construct&& construct) {
+    assert(can_store(vtable["storage_info"_s]) &&
+      "dyno::local_storage: Trying to construct an object described by a "
+      "vtable that won't fit in the storage.");
+
+    construct(static_cast<void*>(&buffer_));
   }
 
   template <typename VTable>
   local_storage(local_storage const& other, VTable const& vtable) {
-    assert(can_store(vtable["storage_info"_s]()) &&
+    assert(can_store(vtable["storage_info"_s]) &&
       "dyno::local_storage: Trying to copy-construct using a vtable that "
       "describes an object that won't fit in the storage.");
 
@@ -427,7 +757,7 @@ public:
 
   template <typename VTable>
   local_storage(local_storage&& other, VTable const& vtable) {
-    assert(can_store(vtable["storage_info"_s]()) &&
+    assert(can_store(vtable["storage_info"_s]) &&
       "dyno::local_storage: Trying to move-construct using a vtable that "
       "describes an object that won't fit in the storage.");
 
@@ -439,6 +769,9 @@ public:
     if (this == &other)
       return;
 
+    if (detail::try_swap_same_type(this_vtable, &this->buffer_, other_vtable, &other.buffer_))
+      return;
+
     // Move `other` into temporary local storage, destructively.
     SBStorage tmp;
     other_vtable["move-construct"_s](&tmp, &other.buffer_);
@@ -453,6 +786,16 @@ public:
     other_vtable["destruct"_s](&tmp);
   }
 
+  template <typename VTable>
+  void* reset(VTable const& vtable, dyno::storage_info info) {
+    assert(can_store(info) &&
+      "dyno::local_storage: Trying to reset the storage for an object that "
+      "won't fit in the storage.");
+
+    vtable["destruct"_s](&buffer_);
+    return &buffer_;
+  }
+
   template <typename VTable>
   void destruct(VTable const& vtable) {
     vtable["destruct"_s](&buffer_);
@@ -485,16 +828,26 @@ struct non_owning_storage {
     : ptr_{&t}
   { }
 
+  // There is no object to reference when constructing in place.
+  template <typename T, typename ...Args>
+  explicit non_owning_storage(std::in_place_type_t<T>, Args&& ...) = delete;
+
   template <typename VTable>
   non_owning_storage(non_owning_storage const& other, VTable const&)
     : ptr_{other.ptr_}
   { }
 
   template <typename VTable>
-  non_owning_storage(non_owning_storage&& other, VTable const&)
+  non_owning_storage(non_owning_storage&& other, VTable const&) noexcept
     : ptr_{other.ptr_}
   { }
 
+  // Reference the object held in another polymorphic storage.
+  template <typename Storage, typename VTable>
+  non_owning_storage(Storage& other, VTable const&)
+    : ptr_{non_owning_storage::get_from(other)}
+  { }
+
   template <typename MyVTable, typename OtherVTable>
   void swap(MyVTable const&, non_owning_storage& other, OtherVTable const&) {
     std::swap(this->ptr_, other.ptr_);
@@ -518,9 +871,83 @@ struct non_owning_storage {
   }
 
 private:
+  template <typename Storage>
+  static void* get_from(Storage& other) {
+    static_assert(!std::is_const<Storage>::value,
+      "dyno::non_owning_storage: Trying to reference an object held in a const "
+      "polymorphic storage. Use dyno::const_non_owning_storage instead.");
+    return other.get();
+  }
+
   void* ptr_;
 };
 
+// Class implementing a non-owning polymorphic reference to a const object.
+//
+// This is like `dyno::non_owning_storage`, except it can reference const
+// objects, and it only ever provides const access to the referenced object.
+// In particular, the non-const `get` also returns a pointer to const.
+struct const_non_owning_storage {
+  const_non_owning_storage() = delete;
+  const_non_owning_storage(const_non_owning_storage const&) = delete;
+  const_non_owning_storage(const_non_owning_storage&&) = delete;
+  const_non_owning_storage& operator=(const_non_owning_storage&&) = delete;
+  const_non_owning_storage& operator=(const_non_owning_storage const&) = delete;
+
+  template <typename T>
+  explicit const_non_owning_storage(T const& t)
+    : ptr_{&t}
+  { }
+
+  template <typename T>
+  explicit const_non_owning_storage(T const&&) = delete;
+
+  // There is no object to reference when constructing in place.
+  template <typename T, typename ...Args>
+  explicit const_non_owning_storage(std::in_place_type_t<T>, Args&& ...) = delete;
+
+  template <typename VTable>
+  const_non_owning_storage(const_non_owning_storage const& other, VTable const&)
+    : ptr_{other.ptr_}
+  { }
+
+  template <typename VTable>
+  const_non_owning_storage(const_non_owning_storage&& other, VTable const&) noexcept
+    : ptr_{other.ptr_}
+  { }
+
+  // Reference the object held in another polymorphic storage, which must not
+  // be a temporary.
+  template <typename Storage, typename VTable>
+  const_non_owning_storage(Storage const& other, VTable const&)
+    : ptr_{other.get()}
+  { }
+
+  template <typename Storage, typename VTable,
+            typename = std::enable_if_t<!std::is_lvalue_reference<Storage>::value>>
+  const_non_owning_storage(Storage&&, VTable const&) = delete;
+
+  template <typename MyVTable, typename OtherVTable>
+  void swap(MyVTable const&, const_non_owning_storage& other, OtherVTable const&) {
+    std::swap(this->ptr_, other.ptr_);
+  }
+
+  template <typename VTable>
+  void destruct(VTable const&) { }
+
+  template <typename T = void>
+  T const* get() const {
+    return static_cast<T const*>(ptr_);
+  }
+
+  static constexpr bool can_store(dyno::storage_info) {
+    return true;
+  }
+
+private:
+  void const* ptr_;
+};
+
 // Class implementing polymorphic storage with a primary storage and a
 // fallback one.
 //
@@ -568,6 +995,31 @@ public:
     new (&second_) Second{std::forward<T>(t)};
   }
 
+  template <typename T, typename ...Args,
+            typename = std::enable_if_t<First::can_store(dyno::storage_info_for<T>)>>
+  explicit fallback_storage(std::in_place_type_t<T>, Args&& ...args) : in_first_{true}
+  { new (&first_) First{std::in_place_type<T>, std::forward<Args>(args)...}; }
+
+  template <typename T, typename ...Args, typename = void,
+            typename = std::enable_if_t<!First::can_store(dyno::storage_info_for<T>)>>
+  explicit fallback_storage(std::in_place_type_t<T>, Args&& ...args) : in_first_{false} {
+    static_assert(can_store(dyno::storage_info_for<T>),
+      "dyno::fallback_storage<First, Second>: Trying to construct a type that "
+      "can neither be stored in the primary nor in the secondary storage.");
+
+    new (&second_) Second{std::in_place_type<T>, std::forward<Args>(args)...};
+  }
+
+  template <typename VTable, typename Construct>
+  fallback_storage(dyno::in_place_construct_t, VTable const& vtable, Construct&& construct)
+    : in_first_{First::can_store(vtable["storage_info"_s])}
+  {
+    if (in_first())
+      new (&first_) First{dyno::in_place_construct, vtable, construct};
+    else
+      new (&second_) Second{dyno::in_place_construct, vtable, construct};
+  }
+
   template <typename VTable>
   fallback_storage(fallback_storage const& other, VTable const& vtable)
     : in_first_{other.in_first_}
@@ -580,6 +1032,8 @@ public:
 
   template <typename VTable>
   fallback_storage(fallback_storage&& other, VTable const& vtable)
+    noexcept(std::is_nothrow_constructible<First, First&&, VTable const&>::value &&
+             std::is_nothrow_constructible<Second, Second&&, VTable const&>::value)
     : in_first_{other.in_first_}
   {
     if (in_first())
@@ -15,6 +15,7 @@
 #include <boost/hana/contains.hpp>
 #include <boost/hana/core/to.hpp>
 #include <boost/hana/difference.hpp>
+#include <boost/hana/equal.hpp>
 #include <boost/hana/first.hpp>
 #include <boost/hana/fold_left.hpp>
 #include <boost/hana/for_each.hpp>
@@ -28,6 +29,8 @@
 #include <boost/hana/type.hpp>
 #include <boost/hana/unpack.hpp>
 
+#include <cstddef>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
@@ -62,38 +65,179 @@ namespace dyno {
 //  Semantics: Return the function with the given name in the vtable if there
 //             is one. The behavior when no such function exists in the vtable
 //             is implementation defined (in most cases that's a compile-time
-//             error).
+//             error). For a `dyno::constant`, the value of the constant is
+//             returned instead of a function, and for a `dyno::field`, the
+//             offset of the member is returned.
+//
+// constexpr bool same_concept_map(Table const&) const;
+//  Semantics: Return whether both vtables are known to have been created from
+//             the same concept map, which means that they are used with objects
+//             of the same type. Returning `false` is always allowed; this is
+//             only used to enable optimizations when the types are the same.
+//
+// Optionally, a vtable may also be able to identify the concept map it was
+// created from:
+//
+// constexpr void const* concept_map_id() const;
+//  Semantics: Return a pointer identifying the concept map the vtable was
+//             created from. Two vtables returning the same pointer were created
+//             from the same concept map, which means that they are used with
+//             objects of the same type. Like for `same_concept_map`, the
+//             opposite is not necessarily true. This is used to group objects
+//             by type, see `dyno::partition_by_type`.
+//
+// Optionally, a vtable may also support being converted from another vtable:
+//
+// template <typename Other> Table(detail::from_vtable_t, Other const&);
+//  Semantics: Construct a vtable with the functions of another vtable, which
+//             must contain at least the functions of the vtable being created.
+//             This is used to convert a `dyno::poly` to a `dyno::poly` of a
+//             concept that its own concept refines.
 
 
 //////////////////////////////////////////////////////////////////////////////
 // Vtable implementations
 
+namespace detail {
+  // Tag used to construct a vtable from another vtable holding (at least) the
+  // same functions, for example when converting a `poly` to a `poly` of a
+  // concept it refines.
+  struct from_vtable_t { };
+  constexpr from_vtable_t from_vtable{};
+
+  // Returns the index of the first name equal to `Name_` in `Names...`, or
+  // `sizeof...(Names)` if there is no such name.
+  template <typename Name_, typename ...Names>
+  constexpr std::size_t index_of_name() {
+    constexpr bool matches[] = {decltype(boost::hana::equal(Names{}, Name_{}))::value..., false};
+    std::size_t i = 0;
+    while (i != sizeof...(Names) && !matches[i])
+      ++i;
+    return i;
+  }
+
+  template <std::size_t N, typename ...Mappings>
+  struct local_vtable_prefix;
+
+  // Describes how a clause is stored in a vtable. Functions are stored as
+  // pointers to thunks, constants are stored as values, and fields are
+  // stored as the offset of the member within the object.
+  template <typename Clause>
+  struct vtable_entry {
+    using type = typename detail::erase_signature<typename Clause::type>::type*;
+
+    template <typename Function>
+    static constexpr type make(Function f)
+    { return detail::erase_function<typename Clause::type>(f); }
+  };
+
+  template <typename Type>
+  struct vtable_entry<dyno::constant_t<Type>> {
+    using type = Type;
+
+    template <typename Value>
+    static constexpr type make(Value)
+    { return Value::value; }
+  };
+
+  template <typename Type>
+  struct vtable_entry<dyno::field_t<Type>> {
+    using type = std::size_t;
+
+    template <typename Offset>
+    static constexpr type make(Offset)
+    { return Offset::value; }
+  };
+} // end namespace detail
+
 // Class implementing a local vtable, i.e. a vtable whose storage is held
 // right where the `local_vtable` is instantiated.
+//
+// A `local_vtable` with mappings `M1, ..., Mn` derives from the `local_vtable`
+// with mappings `M1, ..., Mn-1`, and so on. Hence, a vtable whose functions
+// are a prefix of the functions of another vtable is a base class of that
+// other vtable, which allows a pointer to the latter to be used as a pointer
+// to the former. `dyno::remote_vtable` relies on this to convert vtables
+// without creating new vtables.
 template <typename ...Mappings>
 struct local_vtable;
 
+template <>
+struct local_vtable<> {
+  template <typename ConceptMap>
+  constexpr explicit local_vtable(ConceptMap) { }
+
+  template <typename Other>
+  constexpr local_vtable(detail::from_vtable_t, Other const&) { }
+
+  template <typename Name_>
+  constexpr auto contains(Name_) const {
+    return boost::hana::false_c;
+  }
+
+  template <typename Name_>
+  constexpr auto operator[](Name_) const {
+    static_assert(!std::is_same<Name_, Name_>::value, // make the assertion dependent
+      "dyno::local_vtable::operator[]: Request for a virtual function that is "
+      "not in the vtable. Was this function specified in the concept that "
+      "was used to instantiate this vtable? You can find the contents of the "
+      "vtable and the function you were trying to access in the compiler "
+      "error message, probably in the following format: "
+      "`local_vtable<CONTENTS OF VTABLE>::operator[]<FUNCTION NAME>`");
+  }
+
+  // A local vtable does not know which concept map it was created from, and
+  // comparing the functions themselves is not reliable since different types
+  // may share identical functions.
+  constexpr bool same_concept_map(local_vtable const&) const { return false; }
+
+  friend void swap(local_vtable&, local_vtable&) { }
+};
+
 template <typename ...Name, typename ...Clause>
-struct local_vtable<boost::hana::pair<Name, Clause>...> {
+struct local_vtable<boost::hana::pair<Name, Clause>...>
+  : detail::local_vtable_prefix<
+      sizeof...(Name) - 1, boost::hana::pair<Name, Clause>...
+    >::type
+{
+private:
+  using Prefix = typename detail::local_vtable_prefix<
+    sizeof...(Name) - 1, boost::hana::pair<Name, Clause>...
+  >::type;
+  using LastName = std::tuple_element_t<sizeof...(Name) - 1, std::tuple<Name...>>;
+  using LastClause = std::tuple_element_t<sizeof...(Clause) - 1, std::tuple<Clause...>>;
+
+  template <typename ...>
+  friend struct local_vtable;
+
+public:
   template <typename ConceptMap>
   constexpr explicit local_vtable(ConceptMap map)
-    : vtbl_{boost::hana::make_map(
-      boost::hana::make_pair(Name{}, detail::erase_function<typename Clause::type>(map[Name{}]))...
-    )} {
-    // suppress "unused" warnings for empty parameter packs
-    (void) map;
-  }
+    : Prefix{map}
+    , entry_{detail::vtable_entry<LastClause>::make(map[LastName{}])}
+  { }
+
+  template <typename Other>
+  constexpr local_vtable(detail::from_vtable_t, Other const& other)
+    : Prefix{detail::from_vtable, other}
+    , entry_{other[LastName{}]}
+  { }
 
   template <typename Name_>
-  constexpr auto contains(Name_ name) const {
-    return boost::hana::contains(vtbl_, name);
+  constexpr auto contains(Name_) const {
+    constexpr std::size_t index = detail::index_of_name<Name_, Name...>();
+    return boost::hana::bool_c<index != sizeof...(Name)>;
   }
 
   template <typename Name_>
   constexpr auto operator[](Name_ name) const {
     constexpr bool contains_function = decltype(contains(name))::value;
     if constexpr (contains_function) {
-      return vtbl_[name];
+      constexpr std::size_t index = detail::index_of_name<Name_, Name...>();
+      using Entry = typename detail::local_vtable_prefix<
+        index + 1, boost::hana::pair<Name, Clause>...
+      >::type;
+      return static_cast<Entry const&>(*this).entry_;
     } else {
       static_assert(contains_function,
         "dyno::local_vtable::operator[]: Request for a virtual function that is "
@@ -106,18 +250,27 @@ struct local_vtable<boost::hana::pair<Name, Clause>...> {
   }
 
   friend void swap(local_vtable& a, local_vtable& b) {
-    boost::hana::for_each(boost::hana::keys(a.vtbl_), [&](auto key) {
-      using std::swap;
-      swap(a.vtbl_[key], b.vtbl_[key]);
-    });
+    using std::swap;
+    swap(static_cast<Prefix&>(a), static_cast<Prefix&>(b));
+    swap(a.entry_, b.entry_);
   }
 
 private:
-  boost::hana::map<
-    boost::hana::pair<Name, typename detail::erase_signature<typename Clause::type>::type*>...
-  > vtbl_;
+  typename detail::vtable_entry<LastClause>::type entry_;
 };
 
+namespace detail {
+  // Returns the `local_vtable` holding the first `N` of the given mappings.
+  template <std::size_t N, typename ...Mappings>
+  struct local_vtable_prefix {
+    template <std::size_t ...I>
+    static auto helper(std::index_sequence<I...>)
+      -> dyno::local_vtable<std::tuple_element_t<I, std::tuple<Mappings...>>...>;
+
+    using type = decltype(helper(std::make_index_sequence<N>{}));
+  };
+} // end namespace detail
+
 namespace detail {
   template <typename VTable, typename ConceptMap>
   static VTable const static_vtable{ConceptMap{}};
@@ -132,6 +285,23 @@ struct remote_vtable {
     : vptr_{&detail::static_vtable<VTable, ConceptMap>}
   { }
 
+  // Converts from a remote vtable without creating a new vtable, by pointing
+  // to the part of the other static vtable that holds our functions. This
+  // requires `VTable` to be a base class of the other static vtable, i.e.
+  // the functions of `VTable` must be the first functions of that vtable.
+  template <typename OtherVTable>
+  constexpr remote_vtable(detail::from_vtable_t, remote_vtable<OtherVTable> const& other)
+    : vptr_{remote_vtable::upcast(other.vptr_)}
+  { }
+
+  template <typename Other>
+  constexpr remote_vtable(detail::from_vtable_t, Other const&) {
+    static_assert(!std::is_same<Other, Other>::value, // make the assertion dependent
+      "dyno::remote_vtable: Trying to convert a vtable that is not a remote "
+      "vtable to a remote vtable. This is not supported, since it would require "
+      "creating a new static vtable.");
+  }
+
   template <typename Name>
   constexpr auto operator[](Name name) const {
     return (*vptr_)[name];
@@ -142,15 +312,54 @@ struct remote_vtable {
     return vptr_->contains(name);
   }
 
+  // There is a static vtable per concept map, so two remote vtables pointing
+  // to the same static vtable were created from the same concept map. Note
+  // that the opposite is not true, for example when one of the vtables was
+  // converted from another vtable.
+  constexpr bool same_concept_map(remote_vtable const& other) const {
+    return vptr_ == other.vptr_;
+  }
+
+  // The address of the static vtable identifies the concept map, for the
+  // same reason as above.
+  constexpr void const* concept_map_id() const {
+    return vptr_;
+  }
+
   friend void swap(remote_vtable& a, remote_vtable& b) {
     using std::swap;
     swap(a.vptr_, b.vptr_);
   }
 
 private:
+  template <typename>
+  friend struct remote_vtable;
+
+  template <typename OtherVTable>
+  static constexpr VTable const* upcast(OtherVTable const* vptr) {
+    static_assert(std::is_base_of<VTable, OtherVTable>::value,
+      "dyno::remote_vtable: Trying to convert from a remote vtable whose layout "
+      "is not compatible with this vtable. A remote vtable can only be converted "
+      "to a remote vtable holding the first functions of the original vtable. "
+      "For `dyno::poly`, this means that a poly can only be converted to a poly "
+      "of the first concept refined by its concept, and only when the vtable "
+      "policies of both polys are the same.");
+    return vptr;
+  }
+
   VTable const* vptr_;
 };
 
+namespace detail {
+  template <typename VTable, typename = void>
+  struct has_concept_map_id : std::false_type { };
+
+  template <typename VTable>
+  struct has_concept_map_id<VTable, std::void_t<
+    decltype(std::declval<VTable const&>().concept_map_id())
+  >> : std::true_type { };
+}
+
 // Class implementing a vtable that joins two other vtables.
 //
 // A function is first looked up in the first vtable, and in the second
@@ -164,11 +373,33 @@ struct joined_vtable {
     : first_{map}, second_{map}
   { }
 
+  template <typename OtherFirst, typename OtherSecond>
+  constexpr joined_vtable(detail::from_vtable_t, joined_vtable<OtherFirst, OtherSecond> const& other)
+    : first_{detail::from_vtable, other.first_}
+    , second_{detail::from_vtable, other.second_}
+  { }
+
   template <typename Name>
   constexpr auto contains(Name name) const {
     return first_.contains(name) || second_.contains(name);
   }
 
+  constexpr bool same_concept_map(joined_vtable const& other) const {
+    return first_.same_concept_map(other.first_) || second_.same_concept_map(other.second_);
+  }
+
+  // The concept map is identified by whichever vtable can identify it.
+  template <typename F = First, std::enable_if_t<detail::has_concept_map_id<F>::value, int> = 0>
+  constexpr void const* concept_map_id() const {
+    return first_.concept_map_id();
+  }
+
+  template <typename F = First, std::enable_if_t<!detail::has_concept_map_id<F>::value &&
+                                                 detail::has_concept_map_id<Second>::value, int> = 0>
+  constexpr void const* concept_map_id() const {
+    return second_.concept_map_id();
+  }
+
   template <typename Name>
   constexpr auto operator[](Name name) const {
     auto first_contains_function = first_.contains(name);
@@ -202,6 +433,9 @@ struct joined_vtable {
   }
 
 private:
+  template <typename, typename>
+  friend struct joined_vtable;
+
   First first_;
   Second second_;
 };
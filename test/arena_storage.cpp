@@ -0,0 +1,149 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/arena.hpp>
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This test makes sure that objects held in a `dyno::arena_storage` stay
+// valid when the arena is compacted, even after their `dyno::poly` was moved
+// or swapped, and that compacting the arena releases the memory of the
+// objects that were freed.
+
+struct Entity : decltype(dyno::requires(
+  dyno::CopyConstructible{},
+  dyno::MoveConstructible{},
+  dyno::Destructible{},
+  "name"_s = dyno::method<std::string () const>
+)) { };
+
+struct Small { int n; };
+struct Large { char data[200]; int n; };
+
+struct Tracked {
+  explicit Tracked(std::string s) : text{std::move(s)} { ++alive; }
+  Tracked(Tracked const& other) : text{other.text} { ++alive; }
+  Tracked(Tracked&& other) noexcept : text{std::move(other.text)} { ++alive; ++moves; }
+  ~Tracked() { --alive; }
+  std::string text;
+  static int alive;
+  static int moves;
+};
+int Tracked::alive = 0;
+int Tracked::moves = 0;
+
+template <>
+auto const dyno::concept_map<Entity, Small> = dyno::make_concept_map(
+  "name"_s = [](Small const& self) { return "small" + std::to_string(self.n); }
+);
+
+template <>
+auto const dyno::concept_map<Entity, Large> = dyno::make_concept_map(
+  "name"_s = [](Large const& self) { return "large" + std::to_string(self.n); }
+);
+
+template <>
+auto const dyno::concept_map<Entity, Tracked> = dyno::make_concept_map(
+  "name"_s = [](Tracked const& self) { return "tracked" + self.text; }
+);
+
+struct Tag;
+using Storage = dyno::arena_storage<Tag>;
+using Poly = dyno::poly<Entity, Storage>;
+
+static std::string expected_name(int i) {
+  switch (i % 3) {
+    case 0: return "small" + std::to_string(i);
+    case 1: return "large" + std::to_string(i);
+    default: return "tracked" + std::to_string(i);
+  }
+}
+
+int main() {
+  dyno::arena& arena = Storage::shared_arena();
+  {
+    std::vector<Poly> polys;
+    for (int i = 0; i != 3000; ++i) {
+      switch (i % 3) {
+        case 0: polys.emplace_back(Small{i}); break;
+        case 1: { Large large{}; large.n = i; polys.emplace_back(large); break; }
+        case 2: polys.emplace_back(Tracked{std::to_string(i)}); break;
+      }
+    }
+    DYNO_CHECK(Tracked::alive == 1000);
+    for (int i = 0; i != 3000; ++i)
+      DYNO_CHECK(polys[i].virtual_("name"_s)() == expected_name(i));
+
+    // Free most of the objects, leaving holes in all the blocks.
+    std::size_t reserved = arena.reserved_bytes();
+    std::size_t used = arena.used_bytes();
+    std::vector<Poly> kept;
+    std::vector<int> ids;
+    for (int i = 0; i != 3000; ++i) {
+      if (i % 10 < 2) {
+        kept.push_back(std::move(polys[i]));
+        ids.push_back(i);
+      }
+    }
+    polys.clear();
+    DYNO_CHECK(Tracked::alive == 200);
+    DYNO_CHECK(arena.used_bytes() < used / 4);
+    DYNO_CHECK(arena.reserved_bytes() == reserved);
+
+    // Compacting relocates the live objects next to each other, using the
+    // move constructor of the objects that are not trivially relocatable.
+    Tracked::moves = 0;
+    arena.compact();
+    DYNO_CHECK(Tracked::moves == 200);
+    DYNO_CHECK(Tracked::alive == 200);
+    DYNO_CHECK(arena.reserved_bytes() <= reserved / 2);
+    DYNO_CHECK(arena.used_bytes() <= arena.reserved_bytes());
+    for (std::size_t i = 0; i != kept.size(); ++i)
+      DYNO_CHECK(kept[i].virtual_("name"_s)() == expected_name(ids[i]));
+
+    // Copying, swapping and moving polys keeps track of where they are.
+    {
+      Poly copy{kept[3]}; // a Tracked
+      DYNO_CHECK(Tracked::alive == 201);
+      using std::swap;
+      swap(kept[0], kept[1]);
+      std::swap(ids[0], ids[1]);
+      Poly moved{std::move(kept[4])};
+      kept[4] = std::move(moved);
+      Poly copy_of_moved_from{moved}; // nothing is allocated
+      DYNO_CHECK(copy_of_moved_from.unsafe_get<void>() == nullptr);
+      kept.emplace_back(std::move(copy));
+      ids.push_back(ids[3]);
+      kept.shrink_to_fit();
+
+      arena.compact();
+      DYNO_CHECK(Tracked::alive == 201);
+      for (std::size_t i = 0; i != kept.size(); ++i)
+        DYNO_CHECK(kept[i].virtual_("name"_s)() == expected_name(ids[i]));
+    }
+
+    // An object larger than a block gets its own block.
+    {
+      struct Huge { char data[100000]; };
+      static_assert(dyno::is_trivially_relocatable<Huge>::value);
+      dyno::arena local{1024};
+      void* owner = local.allocate(sizeof(Huge), nullptr, &owner);
+      DYNO_CHECK(local.reserved_bytes() >= sizeof(Huge));
+      local.deallocate(owner);
+      DYNO_CHECK(local.used_bytes() == 0);
+    }
+  }
+  DYNO_CHECK(Tracked::alive == 0);
+  DYNO_CHECK(arena.used_bytes() == 0);
+}
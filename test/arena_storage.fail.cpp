@@ -0,0 +1,36 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno/arena.hpp>
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+using namespace dyno::literals;
+
+
+// This test makes sure that we can't hold an object whose move constructor
+// may throw in a `dyno::arena_storage`, since the objects are relocated when
+// the arena is compacted and that must not fail half-way.
+
+struct Concept : decltype(dyno::requires(
+  dyno::Destructible{},
+  "f"_s = dyno::method<int () const>
+)) { };
+
+struct Foo {
+  Foo() = default;
+  Foo(Foo&&) { }
+  ~Foo() { }
+};
+
+template <>
+auto const dyno::concept_map<Concept, Foo> = dyno::make_concept_map(
+  "f"_s = [](Foo const&) { return 111; }
+);
+
+int main() {
+  // MESSAGE[dyno::arena_storage: The objects held in an arena_storage must be trivially relocatable or have a move constructor that does not throw]
+  dyno::poly<Concept, dyno::arena_storage<>> poly{std::in_place_type<Foo>};
+}
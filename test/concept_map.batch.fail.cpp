@@ -0,0 +1,27 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+
+#include <cstddef>
+using namespace dyno::literals;
+
+
+struct Particle : decltype(dyno::requires(
+  "advance"_s = dyno::batch_function<void (dyno::T*, std::size_t, float)>
+)) { };
+
+struct Foo { };
+
+template <>
+auto const dyno::concept_map<Particle, Foo> = dyno::make_concept_map(
+  "advance"_s = [](Foo& self) { }
+);
+
+int main() {
+  // MESSAGE[dyno::concept_map: The function provided in a concept map for a batch]
+  dyno::poly<Particle> poly{Foo{}};
+}
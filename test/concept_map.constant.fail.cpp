@@ -0,0 +1,25 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+using namespace dyno::literals;
+
+
+struct Prioritized : decltype(dyno::requires(
+  "priority"_s = dyno::constant<int>
+)) { };
+
+struct Foo { };
+
+template <>
+auto const dyno::concept_map<Prioritized, Foo> = dyno::make_concept_map(
+  "priority"_s = [] { return 3; }
+);
+
+int main() {
+  // MESSAGE[dyno::concept_map: The value provided in a concept map for a constant]
+  dyno::poly<Prioritized> poly{Foo{}};
+}
@@ -0,0 +1,27 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+
+#include <cstddef>
+using namespace dyno::literals;
+
+
+struct Identified : decltype(dyno::requires(
+  "id"_s = dyno::field<int>
+)) { };
+
+struct Foo { long id; };
+
+template <>
+auto const dyno::concept_map<Identified, Foo> = dyno::make_concept_map(
+  "id"_s = DYNO_FIELD(Foo, id)
+);
+
+int main() {
+  // MESSAGE[dyno::concept_map: The value provided in a concept map for a field]
+  dyno::poly<Identified> poly{Foo{}};
+}
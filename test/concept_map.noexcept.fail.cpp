@@ -0,0 +1,25 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+using namespace dyno::literals;
+
+
+struct Fooable : decltype(dyno::requires(
+  "foo"_s = dyno::method<void () noexcept>
+)) { };
+
+struct Foo { };
+
+template <>
+auto const dyno::concept_map<Fooable, Foo> = dyno::make_concept_map(
+  "foo"_s = [](Foo&) { }
+);
+
+int main() {
+  // MESSAGE[dyno::concept_map: The function provided in a concept map for a function declared `noexcept`]
+  dyno::poly<Fooable> poly{Foo{}};
+}
@@ -0,0 +1,26 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+using namespace dyno::literals;
+
+
+// This test makes sure that defining `"storage_info"` with a function, which
+// was the way to define it before it became a constant, gives a diagnostic
+// explaining how to define it now.
+
+struct Foo { };
+
+template <>
+auto const dyno::concept_map<dyno::Storable, Foo> = dyno::make_concept_map(
+  "storage_info"_s = []() { return dyno::storage_info_for<Foo>; }
+);
+
+int main() {
+  // MESSAGE[For `"storage_info"`, which used to be a function, use `dyno::storage_info_constant<T>{}`]
+  dyno::poly<dyno::Storable> poly{Foo{}};
+}
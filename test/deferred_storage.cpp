@@ -0,0 +1,159 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/reclaimer.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+using namespace dyno::literals;
+
+
+// Allocations fail while this is set.
+static bool fail_allocations = false;
+
+void* operator new(std::size_t size) {
+  void* ptr = fail_allocations ? nullptr : std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr)
+    throw std::bad_alloc{};
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+
+// This test makes sure that `dyno::deferred_storage` hands the objects that
+// are not trivially destructible to its reclaimer, which destroys them when
+// reclaiming explicitly or on a background thread, and that trivially
+// destructible objects, as well as objects that can't be queued because
+// memory can't be allocated, are destroyed right away.
+
+struct Entity : decltype(dyno::requires(
+  dyno::CopyConstructible{},
+  dyno::MoveConstructible{},
+  dyno::Destructible{},
+  "name"_s = dyno::method<std::string () const>
+)) { };
+
+struct Trivial { int n; };
+
+struct Tracked {
+  explicit Tracked(std::string s) : text{std::move(s)} { ++alive; }
+  Tracked(Tracked const& other) : text{other.text} { ++alive; }
+  Tracked(Tracked&& other) : text{std::move(other.text)} { ++alive; }
+  ~Tracked() {
+    --alive;
+    destroyed_on = std::this_thread::get_id();
+  }
+  std::string text;
+  static std::atomic<int> alive;
+  static std::thread::id destroyed_on;
+};
+std::atomic<int> Tracked::alive{0};
+std::thread::id Tracked::destroyed_on;
+
+static_assert(dyno::storage_info_for<Trivial>.trivially_destructible);
+static_assert(!dyno::storage_info_for<Tracked>.trivially_destructible);
+
+template <>
+auto const dyno::concept_map<Entity, Trivial> = dyno::make_concept_map(
+  "name"_s = [](Trivial const& self) { return "trivial" + std::to_string(self.n); }
+);
+
+template <>
+auto const dyno::concept_map<Entity, Tracked> = dyno::make_concept_map(
+  "name"_s = [](Tracked const& self) { return "tracked" + self.text; }
+);
+
+struct Manual;
+struct Background;
+struct Failing;
+
+int main() {
+  // Objects are destroyed when reclaiming explicitly.
+  {
+    using Storage = dyno::deferred_storage<Manual>;
+    using Poly = dyno::poly<Entity, Storage>;
+    dyno::reclaimer& reclaimer = Storage::shared_reclaimer();
+    {
+      Poly trivial{Trivial{1}};
+      Poly tracked{Tracked{"a"}};
+      DYNO_CHECK(Tracked::alive == 1);
+      DYNO_CHECK(trivial.virtual_("name"_s)() == "trivial1");
+      DYNO_CHECK(tracked.virtual_("name"_s)() == "trackeda");
+
+      // Copying, moving and swapping behave like with a remote storage.
+      Poly copy{tracked};
+      Poly moved{std::move(copy)};
+      DYNO_CHECK(Tracked::alive == 2);
+      using std::swap;
+      swap(trivial, moved);
+      DYNO_CHECK(trivial.virtual_("name"_s)() == "trackeda");
+      DYNO_CHECK(moved.virtual_("name"_s)() == "trivial1");
+    }
+    // The moved-from poly has nothing to retire, and `Trivial` was destroyed.
+    DYNO_CHECK(Tracked::alive == 2);
+    DYNO_CHECK(reclaimer.pending() == 2);
+    DYNO_CHECK(reclaimer.reclaim() == 2);
+    DYNO_CHECK(Tracked::alive == 0);
+    DYNO_CHECK(Tracked::destroyed_on == std::this_thread::get_id());
+    DYNO_CHECK(reclaimer.pending() == 0);
+    DYNO_CHECK(reclaimer.reclaim() == 0);
+  }
+
+  // Objects are destroyed by the background thread as they are retired.
+  {
+    using Storage = dyno::deferred_storage<Background>;
+    using Poly = dyno::poly<Entity, Storage>;
+    dyno::reclaimer& reclaimer = Storage::shared_reclaimer();
+    reclaimer.start_background_thread();
+    reclaimer.start_background_thread(); // does nothing
+    {
+      std::vector<Poly> polys;
+      for (int i = 0; i != 1000; ++i)
+        polys.emplace_back(Tracked{std::to_string(i)});
+      DYNO_CHECK(Tracked::alive == 1000);
+    }
+    reclaimer.stop_background_thread();
+    DYNO_CHECK(reclaimer.pending() == 0);
+    DYNO_CHECK(Tracked::alive == 0);
+    DYNO_CHECK(Tracked::destroyed_on != std::this_thread::get_id());
+
+    // Once the thread is stopped, the objects wait to be reclaimed.
+    { Poly tracked{Tracked{"b"}}; }
+    DYNO_CHECK(reclaimer.pending() == 1);
+    DYNO_CHECK(Tracked::alive == 1);
+    reclaimer.start_background_thread();
+    reclaimer.stop_background_thread();
+    DYNO_CHECK(Tracked::alive == 0);
+  }
+
+  // Objects that can't be queued are destroyed right away, without throwing.
+  {
+    using Storage = dyno::deferred_storage<Failing>;
+    using Poly = dyno::poly<Entity, Storage>;
+    dyno::reclaimer& reclaimer = Storage::shared_reclaimer();
+    {
+      Poly tracked{Tracked{"c"}};
+      DYNO_CHECK(Tracked::alive == 1);
+      fail_allocations = true;
+    }
+    fail_allocations = false;
+    DYNO_CHECK(Tracked::alive == 0);
+    DYNO_CHECK(Tracked::destroyed_on == std::this_thread::get_id());
+    DYNO_CHECK(reclaimer.pending() == 0);
+  }
+}
@@ -57,6 +57,17 @@ int main() {
     DYNO_CHECK(i == 4);
   }
 
+  // erase_function should construct a placeholder returned by value at the
+  // address passed as the first argument
+  {
+    int i = 3;
+    auto next = dyno::detail::erase_function<dyno::T (dyno::T const&)>([](int const& x) { return x + 1; });
+    int result = 0;
+    next(static_cast<void*>(&result), static_cast<void const*>(&i));
+    DYNO_CHECK(result == 4);
+    DYNO_CHECK(i == 3);
+  }
+
   // erase_function should be able to erase a function that is more cv-qualified
   {
     {
@@ -5,6 +5,7 @@
 #include <dyno/concept.hpp>
 #include <dyno/detail/erase_signature.hpp>
 
+#include <string>
 #include <type_traits>
 
 
@@ -38,6 +39,30 @@ static_assert(std::is_same<
   void* (void*)
 >{}, "");
 
+// Parameters taken by value that are expensive to copy are passed by rvalue
+// reference, but not the return type
+static_assert(std::is_same<
+  dyno::detail::erase_signature<std::string (dyno::T&, std::string)>::type,
+  std::string (void*, std::string&&)
+>{}, "");
+
+static_assert(std::is_same<
+  dyno::detail::erase_signature<void (std::string&, std::string const&)>::type,
+  void (std::string&, std::string const&)
+>{}, "");
+
+// A placeholder returned by value is constructed at an address passed as an
+// additional first parameter
+static_assert(std::is_same<
+  dyno::detail::erase_signature<dyno::T (dyno::T const&, std::string)>::type,
+  void (void*, void const*, std::string&&)
+>{}, "");
+
+static_assert(std::is_same<
+  dyno::detail::erase_signature<dyno::T () noexcept>::type,
+  void (void*) noexcept
+>{}, "");
+
 // Check with C-style varargs
 static_assert(std::is_same<
   dyno::detail::erase_signature<char (int, ...)>::type,
@@ -59,4 +84,9 @@ static_assert(std::is_same<
   void (void*, ...)
 >{}, "");
 
+static_assert(std::is_same<
+  dyno::detail::erase_signature<dyno::T (dyno::T&, ...)>::type,
+  void (void*, void*, ...)
+>{}, "");
+
 int main() { }
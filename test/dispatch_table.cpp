@@ -0,0 +1,97 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/dispatch_table.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/storage.hpp>
+
+#include <string>
+using namespace dyno::literals;
+
+
+// This test makes sure that `dyno::dispatch_table` calls the function
+// registered for the dynamic types of both of its arguments, even when
+// those types are different, and that each table only indexes the types
+// registered in it.
+
+struct Shape : decltype(dyno::requires(
+  dyno::TypeIndex{}
+)) { };
+
+struct Circle { int radius; };
+struct Square { int side; };
+struct Triangle { };
+template <int> struct Many { };
+
+int main() {
+  dyno::dispatch_table<Shape, std::string (dyno::T const&, dyno::T const&, int)> collide;
+  collide.define<Circle, Circle>([](Circle const& a, Circle const& b, int n) {
+    return "circle-circle " + std::to_string(a.radius + b.radius + n);
+  });
+  collide.define<Circle, Square>([](Circle const& a, Square const& b, int n) {
+    return "circle-square " + std::to_string(a.radius + b.side + n);
+  });
+  collide.define<Square, Circle>([](Square const& a, Circle const& b, int n) {
+    return "square-circle " + std::to_string(a.side + b.radius + n);
+  });
+
+  dyno::poly<Shape> circle{Circle{1}};
+  dyno::poly<Shape> square{Square{10}};
+  dyno::poly<Shape> triangle{Triangle{}};
+
+  DYNO_CHECK(collide(circle, circle, 100) == "circle-circle 102");
+  DYNO_CHECK(collide(circle, square, 100) == "circle-square 111");
+  DYNO_CHECK(collide(square, circle, 100) == "square-circle 111");
+
+  // The index of the types is read from the vtable, and it is only assigned
+  // to the types registered in some table.
+  DYNO_CHECK(circle.virtual_("type_index"_s)->load() == dyno::type_index_for<Circle>());
+  DYNO_CHECK(triangle.virtual_("type_index"_s)->load() == dyno::type_index_slot::none);
+
+  DYNO_CHECK(collide.contains(circle, square));
+  DYNO_CHECK(!collide.contains(square, square));
+  DYNO_CHECK(!collide.contains(circle, triangle));
+
+  // Registering functions for new types keeps the existing ones.
+  collide.define<Triangle, Square>([](auto const&, auto const& b, int n) {
+    return "triangle-square " + std::to_string(b.side + n);
+  });
+  DYNO_CHECK(collide(triangle, square, 100) == "triangle-square 110");
+  DYNO_CHECK(collide(circle, square, 100) == "circle-square 111");
+
+  // The table only grows with the types registered in it, even when many
+  // other types were assigned an index.
+  {
+    dyno::type_index_for<Many<0>>();
+    dyno::type_index_for<Many<1>>();
+    dyno::type_index_for<Many<2>>();
+    dyno::dispatch_table<Shape, int (dyno::T const&, dyno::T const&)> compare;
+    compare.define<Many<2>, Circle>([](Many<2> const&, Circle const& c) { return c.radius; });
+    dyno::poly<Shape> many{Many<2>{}};
+    DYNO_CHECK(compare.contains(many, circle));
+    DYNO_CHECK(!compare.contains(circle, many));
+    DYNO_CHECK(!compare.contains(many, square));
+    DYNO_CHECK(compare(many, circle) == 1);
+  }
+
+  // The two arguments don't need to be `poly`s of the same type.
+  {
+    dyno::poly<Shape, dyno::local_storage<16>> local_square{Square{20}};
+    DYNO_CHECK(collide(circle, local_square, 0) == "circle-square 21");
+  }
+
+  // Non-const placeholders get a non-const object.
+  {
+    dyno::dispatch_table<Shape, void (dyno::T&, dyno::T const&)> absorb;
+    absorb.define<Circle, Square>([](Circle& a, Square const& b) {
+      a.radius += b.side;
+    });
+    absorb(circle, square);
+    DYNO_CHECK(circle.unsafe_get<Circle>()->radius == 11);
+  }
+}
@@ -0,0 +1,22 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/dispatch_table.hpp>
+using namespace dyno::literals;
+
+
+// This test makes sure that creating a dispatch table for a concept that
+// does not refine `dyno::TypeIndex` gives a proper diagnostic.
+
+struct Shape : decltype(dyno::requires(
+  dyno::TypeId{}
+)) { };
+
+int main() {
+  // MESSAGE[dyno::dispatch_table: The concept of a dispatch table must refine dyno::TypeIndex]
+  dyno::dispatch_table<Shape, bool (dyno::T const&, dyno::T const&)> table;
+  (void)table;
+}
@@ -0,0 +1,125 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/algorithm.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/vtable.hpp>
+
+#include <vector>
+using namespace dyno::literals;
+
+
+// This test makes sure that `dyno::invoke_each` calls the function on each
+// `poly` exactly once, grouping the `poly`s holding objects of the same type,
+// in order within each group. The order across groups is unspecified, so the
+// recorded values are split by type (the values of `B`s are at least 100).
+
+struct Concept : decltype(dyno::requires(
+  "add"_s = dyno::method<void (int&, int)>,
+  "record"_s = dyno::method<void (std::vector<int>&) const>,
+  "value"_s = dyno::function<int (dyno::T const&)>,
+  "accumulate"_s = dyno::function<void (dyno::T const&, int&)>
+)) { };
+
+struct A { int value; };
+struct B { int value; };
+
+template <typename T>
+auto const dyno::default_concept_map<Concept, T> = dyno::make_concept_map(
+  "add"_s = [](T& self, int& total, int n) { self.value += n; total += n; },
+  "record"_s = [](T const& self, std::vector<int>& out) { out.push_back(self.value); },
+  "value"_s = [](T const& self) { return self.value; },
+  "accumulate"_s = [](T const& self, int& total) { total += self.value; }
+);
+
+// Returns the recorded values of the `A`s followed by those of the `B`s.
+std::vector<int> split(std::vector<int> const& values) {
+  std::vector<int> as, bs;
+  for (int value : values)
+    (value >= 100 ? bs : as).push_back(value);
+  as.insert(as.end(), bs.begin(), bs.end());
+  return as;
+}
+
+template <typename VTablePolicy>
+void test() {
+  using Poly = dyno::poly<Concept, dyno::remote_storage, VTablePolicy>;
+  std::vector<Poly> polys;
+  for (int i = 0; i != 10; ++i) {
+    if (i % 3 == 0)
+      polys.push_back(Poly{B{100 + i}});
+    else
+      polys.push_back(Poly{A{i}});
+  }
+
+  // Non-const methods, with arguments passed as lvalues to each call.
+  {
+    int total = 0;
+    dyno::invoke_each(polys, "add"_s, total, 1);
+    DYNO_CHECK(total == 10);
+    for (int i = 0; i != 10; ++i)
+      DYNO_CHECK(polys[i].virtual_("value"_s)(polys[i]) == (i % 3 == 0 ? 101 + i : i + 1));
+  }
+
+  // The calls are grouped by type, and they are made in order within each
+  // group.
+  {
+    std::vector<int> values;
+    dyno::invoke_each(polys, "record"_s, values);
+    DYNO_CHECK((split(values) == std::vector<int>{2, 3, 5, 6, 8, 9, 101, 104, 107, 110}));
+  }
+
+  // Polys that are already grouped are called in order.
+  {
+    std::vector<Poly> grouped;
+    grouped.push_back(Poly{A{1}});
+    grouped.push_back(Poly{A{2}});
+    grouped.push_back(Poly{B{103}});
+    grouped.push_back(Poly{B{104}});
+    std::vector<int> values;
+    dyno::invoke_each(grouped, "record"_s, values);
+    DYNO_CHECK((values == std::vector<int>{1, 2, 103, 104}));
+  }
+
+  // Runs of polys holding objects of the same type are handled properly.
+  {
+    std::vector<Poly> runs;
+    runs.push_back(Poly{A{1}});
+    runs.push_back(Poly{A{2}});
+    runs.push_back(Poly{B{103}});
+    runs.push_back(Poly{A{4}});
+    runs.push_back(Poly{B{105}});
+    runs.push_back(Poly{B{106}});
+    std::vector<int> values;
+    dyno::invoke_each(runs, "record"_s, values);
+    DYNO_CHECK((split(values) == std::vector<int>{1, 2, 4, 103, 105, 106}));
+  }
+
+  // Const ranges and functions taking the poly explicitly are supported.
+  {
+    std::vector<Poly> const& cpolys = polys;
+    int total = 0;
+    dyno::invoke_each(cpolys, "accumulate"_s, total);
+    DYNO_CHECK(total == 101 + 104 + 107 + 110 + 2 + 3 + 5 + 6 + 8 + 9);
+  }
+
+  // Empty ranges are fine.
+  {
+    std::vector<Poly> empty;
+    int total = 0;
+    dyno::invoke_each(empty, "add"_s, total, 1);
+    DYNO_CHECK(total == 0);
+  }
+}
+
+int main() {
+  test<dyno::vtable<dyno::remote<dyno::everything>>>();
+  test<dyno::vtable<dyno::local<dyno::everything>>>();
+  test<dyno::vtable<dyno::local<dyno::only<decltype("add"_s)>>,
+                    dyno::remote<dyno::everything_else>>>();
+}
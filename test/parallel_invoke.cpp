@@ -0,0 +1,147 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/parallel_invoke.hpp>
+#include <dyno/poly.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This test makes sure that `dyno::parallel_invoke` calls the function on each
+// `poly` exactly once, whatever the number of threads and the way the work is
+// split, that exceptions are propagated to the caller, and that an executor
+// can be reused after that.
+
+struct Concept : decltype(dyno::requires(
+  dyno::MoveConstructible{},
+  "visit"_s = dyno::method<void (std::atomic<int>&)>,
+  "visits"_s = dyno::method<int () const>
+)) { };
+
+// The cost of a call depends on the type, like in simulations where some
+// types are much more expensive than others.
+template <int Cost>
+struct Model {
+  int visits = 0;
+  int fail_at = -1;
+};
+
+template <int Cost>
+auto const dyno::concept_map<Concept, Model<Cost>> = dyno::make_concept_map(
+  "visit"_s = [](Model<Cost>& self, std::atomic<int>& total) {
+    if (self.fail_at == self.visits)
+      throw std::runtime_error{"visit failed"};
+    volatile int sink = 0;
+    for (int i = 0; i != Cost; ++i)
+      sink = sink + i;
+    ++self.visits;
+    ++total;
+  },
+  "visits"_s = [](Model<Cost> const& self) { return self.visits; }
+);
+
+using Poly = dyno::poly<Concept>;
+
+std::vector<Poly> make_models(std::size_t n) {
+  std::vector<Poly> models;
+  for (std::size_t i = 0; i != n; ++i) {
+    if (i % 7 == 3)
+      models.emplace_back(Model<10000>{});
+    else if (i % 2 == 0)
+      models.emplace_back(Model<1>{});
+    else
+      models.emplace_back(Model<100>{});
+  }
+  return models;
+}
+
+int main() {
+  for (std::size_t threads : {1, 2, 4, 8}) {
+    dyno::parallel_executor executor{threads};
+    DYNO_CHECK(executor.threads() == threads);
+    for (bool group_by_type : {false, true}) {
+      for (std::size_t n : {0, 1, 5, 1000}) {
+        std::vector<Poly> models = make_models(n);
+        dyno::parallel_options options;
+        options.group_by_type = group_by_type;
+        options.chunk_duration = std::chrono::microseconds{10};
+
+        std::atomic<int> total{0};
+        dyno::parallel_invoke(executor, options, models.begin(), models.end(), "visit"_s, total);
+        DYNO_CHECK(total == int(n));
+        for (Poly const& model : models)
+          DYNO_CHECK(model.virtual_("visits"_s)() == 1);
+      }
+    }
+  }
+
+  // With the default options, and with the shared executor.
+  {
+    std::vector<Poly> models = make_models(100);
+    std::atomic<int> total{0};
+    dyno::parallel_invoke(models.begin(), models.end(), "visit"_s, total);
+    DYNO_CHECK(total == 100);
+
+    dyno::parallel_executor executor{3};
+    dyno::parallel_invoke(executor, models.begin(), models.end(), "visit"_s, total);
+    DYNO_CHECK(total == 200);
+
+    dyno::parallel_options options;
+    options.group_by_type = true;
+    dyno::parallel_invoke(options, models.begin(), models.end(), "visit"_s, total);
+    DYNO_CHECK(total == 300);
+    DYNO_CHECK(&dyno::parallel_executor::shared() == &dyno::parallel_executor::shared());
+  }
+
+  // Exceptions are rethrown in the calling thread, from any thread, and the
+  // executor can still be used afterwards.
+  {
+    dyno::parallel_executor executor{4};
+    for (std::size_t failing : {0, 502, 998}) {
+      std::vector<Poly> models = make_models(1000);
+      models[failing].unsafe_get<Model<1>>()->fail_at = 0;
+      std::atomic<int> total{0};
+      bool thrown = false;
+      try {
+        dyno::parallel_invoke(executor, models.begin(), models.end(), "visit"_s, total);
+      } catch (std::runtime_error const&) {
+        thrown = true;
+      }
+      DYNO_CHECK(thrown);
+      DYNO_CHECK(models[failing].virtual_("visits"_s)() == 0);
+
+      std::vector<Poly> others = make_models(1000);
+      total = 0;
+      dyno::parallel_invoke(executor, others.begin(), others.end(), "visit"_s, total);
+      DYNO_CHECK(total == 1000);
+    }
+  }
+
+  // Calls using the same executor from several threads are serialized.
+  {
+    dyno::parallel_executor executor{2};
+    std::vector<Poly> models = make_models(1000);
+    std::atomic<int> total{0};
+    std::thread other{[&] {
+      for (int i = 0; i != 10; ++i)
+        dyno::parallel_invoke(executor, models.begin(), models.begin() + 500, "visit"_s, total);
+    }};
+    for (int i = 0; i != 10; ++i)
+      dyno::parallel_invoke(executor, models.begin() + 500, models.end(), "visit"_s, total);
+    other.join();
+    DYNO_CHECK(total == 10000);
+    for (Poly const& model : models)
+      DYNO_CHECK(model.virtual_("visits"_s)() == 10);
+  }
+}
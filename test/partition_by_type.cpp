@@ -0,0 +1,100 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/algorithm.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/storage.hpp>
+#include <dyno/vtable.hpp>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This test makes sure that `dyno::partition_by_type` puts `poly`s holding
+// objects of the same type next to each other, without losing any object.
+
+struct Concept : decltype(dyno::requires(
+  dyno::CopyConstructible{},
+  dyno::MoveConstructible{},
+  "kind"_s = dyno::method<int () const>,
+  "value"_s = dyno::method<int () const>
+)) { };
+
+template <int Kind>
+struct Object { int value; };
+
+template <int Kind>
+auto const dyno::concept_map<Concept, Object<Kind>> = dyno::make_concept_map(
+  "kind"_s = [](Object<Kind> const&) { return Kind; },
+  "value"_s = [](Object<Kind> const& self) { return self.value; }
+);
+
+template <typename Storage, typename VTablePolicy>
+void test() {
+  using Poly = dyno::poly<Concept, Storage, VTablePolicy>;
+  std::vector<Poly> polys;
+  int kinds[] = {2, 0, 1, 2, 2, 0, 1, 1, 0, 2, 1, 0};
+  for (int i = 0; i != 12; ++i) {
+    switch (kinds[i]) {
+      case 0: polys.emplace_back(Object<0>{i}); break;
+      case 1: polys.emplace_back(Object<1>{i}); break;
+      case 2: polys.emplace_back(Object<2>{i}); break;
+    }
+  }
+
+  dyno::partition_by_type(polys);
+
+  // The groups appear in order of first appearance of their type.
+  DYNO_CHECK(polys.size() == 12);
+  int expected_kinds[] = {2, 2, 2, 2, 0, 0, 0, 0, 1, 1, 1, 1};
+  for (std::size_t i = 0; i != polys.size(); ++i)
+    DYNO_CHECK(polys[i].virtual_("kind"_s)() == expected_kinds[i]);
+
+  // Each object is still there, held by a poly of the right type.
+  std::vector<bool> seen(12, false);
+  for (auto& poly : polys) {
+    int value = poly.virtual_("value"_s)();
+    DYNO_CHECK(!seen[value]);
+    DYNO_CHECK(kinds[value] == poly.virtual_("kind"_s)());
+    seen[value] = true;
+  }
+
+  // Partitioning an empty vector or an already partitioned one is fine.
+  dyno::partition_by_type(polys);
+  for (std::size_t i = 0; i != polys.size(); ++i)
+    DYNO_CHECK(polys[i].virtual_("kind"_s)() == expected_kinds[i]);
+
+  std::vector<Poly> empty;
+  dyno::partition_by_type(empty);
+  DYNO_CHECK(empty.empty());
+}
+
+// With many types, the groups are still found properly.
+template <int ...Kind>
+void test_many(std::integer_sequence<int, Kind...>) {
+  using Poly = dyno::poly<Concept>;
+  std::vector<Poly> polys;
+  for (int round = 0; round != 3; ++round)
+    (polys.emplace_back(Object<Kind>{round}), ...);
+
+  dyno::partition_by_type(polys);
+  for (std::size_t i = 0; i != polys.size(); ++i) {
+    DYNO_CHECK(polys[i].virtual_("kind"_s)() == static_cast<int>(i / 3));
+    DYNO_CHECK(polys[i].virtual_("value"_s)() >= 0);
+  }
+}
+
+int main() {
+  test_many(std::make_integer_sequence<int, 40>{});
+  test<dyno::remote_storage, dyno::vtable<dyno::remote<dyno::everything>>>();
+  test<dyno::sbo_storage<16>, dyno::vtable<dyno::remote<dyno::everything>>>();
+  test<dyno::local_storage<16>, dyno::vtable<dyno::local<dyno::only<decltype("kind"_s)>>,
+                                             dyno::remote<dyno::everything_else>>>();
+}
@@ -0,0 +1,144 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/storage.hpp>
+
+#include <string>
+#include <utility>
+using namespace dyno::literals;
+
+
+// This test makes sure that copy-assigning and emplacing into a `dyno::poly`
+// reuse the memory held by the storage whenever the new object fits in it.
+
+struct Concept : decltype(dyno::requires(
+  dyno::CopyConstructible{},
+  dyno::MoveConstructible{},
+  "value"_s = dyno::method<std::string () const>
+)) { };
+
+// Copying must not throw for the memory to be reused, see `poly.assign.throw.cpp`.
+template <std::size_t Size>
+struct Object {
+  Object(char const* v) noexcept : value{v} { }
+  char const* value;
+  char padding[Size];
+};
+
+template <std::size_t Size>
+auto const dyno::default_concept_map<Concept, Object<Size>> = dyno::make_concept_map(
+  "value"_s = [](Object<Size> const& self) { return std::string{self.value}; }
+);
+
+using Small = Object<1>;
+using Medium = Object<64>;
+using Big = Object<128>;
+
+template <typename Storage>
+void test() {
+  using Poly = dyno::poly<Concept, Storage>;
+
+  // Copy-assignment of a same-sized object
+  {
+    Poly a{Medium{"a"}};
+    Poly b{Medium{"b"}};
+    void* address = a.template unsafe_get<void>();
+    a = b;
+    DYNO_CHECK(a.virtual_("value"_s)() == "b");
+    DYNO_CHECK(b.virtual_("value"_s)() == "b");
+    DYNO_CHECK(a.template unsafe_get<void>() == address);
+  }
+
+  // Copy-assignment of a smaller object, then back to a larger one
+  {
+    Poly a{Big{"a"}};
+    Poly b{Medium{"b"}};
+    Poly c{Big{"c"}};
+    void* address = a.template unsafe_get<void>();
+    a = b;
+    DYNO_CHECK(a.virtual_("value"_s)() == "b");
+    DYNO_CHECK(a.template unsafe_get<void>() == address);
+    a = c;
+    DYNO_CHECK(a.virtual_("value"_s)() == "c");
+  }
+
+  // Copy-assignment of objects held in a small buffer
+  {
+    Poly a{Small{"a"}};
+    Poly b{Small{"b"}};
+    Poly c{Big{"c"}};
+    a = b;
+    DYNO_CHECK(a.virtual_("value"_s)() == "b");
+    a = c;
+    DYNO_CHECK(a.virtual_("value"_s)() == "c");
+    a = b;
+    DYNO_CHECK(a.virtual_("value"_s)() == "b");
+  }
+
+  // Self-assignment
+  {
+    Poly a{Medium{"a"}};
+    Poly& self = a;
+    a = self;
+    DYNO_CHECK(a.virtual_("value"_s)() == "a");
+  }
+
+  // Assignment to a moved-from poly
+  {
+    Poly a{Medium{"a"}};
+    Poly b{Big{"b"}};
+    Poly c{std::move(a)};
+    a = b;
+    DYNO_CHECK(a.virtual_("value"_s)() == "b");
+    DYNO_CHECK(c.virtual_("value"_s)() == "a");
+  }
+
+  // emplace
+  {
+    Poly a{Medium{"a"}};
+    void* address = a.template unsafe_get<void>();
+    a.template emplace<Medium>("b");
+    DYNO_CHECK(a.virtual_("value"_s)() == "b");
+    DYNO_CHECK(a.template unsafe_get<void>() == address);
+    a.template emplace<Big>("c");
+    DYNO_CHECK(a.virtual_("value"_s)() == "c");
+    a.template emplace<Small>("d");
+    DYNO_CHECK(a.virtual_("value"_s)() == "d");
+  }
+}
+
+int main() {
+  test<dyno::remote_storage>();
+  test<dyno::sbo_storage<32>>();
+
+  // The memory is reused by local storage, too.
+  {
+    using Poly = dyno::poly<Concept, dyno::local_storage<256>>;
+    Poly a{Small{"a"}};
+    Poly b{Big{"b"}};
+    a = b;
+    DYNO_CHECK(a.virtual_("value"_s)() == "b");
+    a.emplace<Medium>("c");
+    DYNO_CHECK(a.virtual_("value"_s)() == "c");
+  }
+
+  // Storages that can't be reused still support assignment.
+  {
+    using Poly = dyno::poly<Concept, dyno::shared_remote_storage>;
+    Poly a{Small{"a"}};
+    Poly b{Big{"b"}};
+    a = b;
+    DYNO_CHECK(a.virtual_("value"_s)() == "b");
+    DYNO_CHECK(a.unsafe_get<void>() == b.unsafe_get<void>());
+    a.emplace<Medium>("c");
+    DYNO_CHECK(a.virtual_("value"_s)() == "c");
+    DYNO_CHECK(b.virtual_("value"_s)() == "b");
+  }
+}
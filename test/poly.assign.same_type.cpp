@@ -0,0 +1,171 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/storage.hpp>
+#include <dyno/vtable.hpp>
+
+#include <string>
+#include <utility>
+using namespace dyno::literals;
+
+
+// This test makes sure that assigning a `dyno::poly` from a `poly` holding an
+// object of the same type uses the assignment operators of that type when the
+// concept includes `dyno::CopyAssignable`, but only when it is correct to do so.
+
+struct Concept : decltype(dyno::requires(
+  dyno::CopyConstructible{},
+  dyno::CopyAssignable{}
+)) { };
+
+int copy_constructions = 0;
+int copy_assignments = 0;
+int move_assignments = 0;
+
+struct Counted {
+  Counted() = default;
+  Counted(Counted const&) { ++copy_constructions; }
+  Counted(Counted&&) = default;
+  Counted& operator=(Counted const&) { ++copy_assignments; return *this; }
+  Counted& operator=(Counted&&) { ++move_assignments; return *this; }
+};
+
+struct Other {
+  int value;
+};
+
+// Not assignable, but still a model of `dyno::CopyAssignable`.
+struct Constant {
+  int const value;
+};
+
+void reset_counters() {
+  copy_constructions = copy_assignments = move_assignments = 0;
+}
+
+template <typename Storage, typename VTable>
+using Poly = dyno::poly<Concept, Storage, VTable>;
+
+using Remote = dyno::vtable<dyno::remote<dyno::everything>>;
+using Local = dyno::vtable<dyno::local<dyno::everything>>;
+
+template <typename Storage>
+void test() {
+  // Objects of the same type are assigned.
+  {
+    Poly<Storage, Remote> a{Counted{}};
+    Poly<Storage, Remote> b{Counted{}};
+    void* address = a.template unsafe_get<void>();
+
+    reset_counters();
+    a = b;
+    DYNO_CHECK(copy_assignments == 1);
+    DYNO_CHECK(copy_constructions == 0);
+    DYNO_CHECK(a.template unsafe_get<void>() == address);
+
+    reset_counters();
+    a = std::move(b);
+    DYNO_CHECK(move_assignments == 1);
+    DYNO_CHECK(a.template unsafe_get<void>() == address);
+  }
+
+  // Objects of different types are not.
+  {
+    Poly<Storage, Remote> a{Other{1}};
+    Poly<Storage, Remote> b{Counted{}};
+    reset_counters();
+    a = b;
+    DYNO_CHECK(copy_assignments == 0);
+    DYNO_CHECK(copy_constructions == 1);
+
+    Poly<Storage, Remote> c{Other{2}};
+    a = std::move(c);
+    DYNO_CHECK(a.template unsafe_get<Other>()->value == 2);
+  }
+
+  // The resources held by the object are reused.
+  {
+    std::string long_string(100, 'x');
+    Poly<Storage, Remote> a{long_string};
+    Poly<Storage, Remote> b{std::string{"short"}};
+    char const* buffer = a.template unsafe_get<std::string>()->data();
+    a = b;
+    DYNO_CHECK(*a.template unsafe_get<std::string>() == "short");
+    DYNO_CHECK(a.template unsafe_get<std::string>()->data() == buffer);
+  }
+}
+
+int main() {
+  test<dyno::remote_storage>();
+  test<dyno::sbo_storage<16>>();
+  test<dyno::local_storage<32>>();
+
+  // Assigning to a moved-from poly reconstructs the object.
+  {
+    Poly<dyno::remote_storage, Remote> a{Counted{}};
+    Poly<dyno::remote_storage, Remote> b{Counted{}};
+    Poly<dyno::remote_storage, Remote> c{std::move(a)};
+    reset_counters();
+    a = b;
+    DYNO_CHECK(copy_assignments == 0);
+    DYNO_CHECK(copy_constructions == 1);
+  }
+
+  // Assigning from a moved-from poly doesn't assign from a missing object.
+  {
+    Poly<dyno::remote_storage, Remote> b{Counted{}};
+    Poly<dyno::remote_storage, Remote> a{std::move(b)};
+    Poly<dyno::remote_storage, Remote> c{Counted{}};
+    reset_counters();
+    c = std::move(b);
+    DYNO_CHECK(move_assignments == 0);
+    DYNO_CHECK(c.unsafe_get<void>() == nullptr);
+  }
+
+  // Objects that are not assignable are reconstructed instead.
+  {
+    static_assert(dyno::models<Concept, Constant>);
+    Poly<dyno::remote_storage, Remote> a{Constant{1}};
+    Poly<dyno::remote_storage, Remote> b{Constant{2}};
+    a = b;
+    DYNO_CHECK(a.unsafe_get<Constant>()->value == 2);
+    Poly<dyno::remote_storage, Remote> c{Constant{3}};
+    a = std::move(c);
+    DYNO_CHECK(a.unsafe_get<Constant>()->value == 3);
+
+    int captured = 4;
+    auto lambda = [captured] { return captured; };
+    Poly<dyno::sbo_storage<16>, Remote> d{lambda};
+    Poly<dyno::sbo_storage<16>, Remote> e{lambda};
+    d = e;
+    DYNO_CHECK((*d.unsafe_get<decltype(lambda)>())() == 4);
+  }
+
+  // A local vtable can't tell whether the types are the same.
+  {
+    Poly<dyno::remote_storage, Local> a{Counted{}};
+    Poly<dyno::remote_storage, Local> b{Counted{}};
+    reset_counters();
+    a = b;
+    DYNO_CHECK(copy_assignments == 0);
+    DYNO_CHECK(copy_constructions == 1);
+  }
+
+  // Assigning to a shared object would change other polys sharing it.
+  {
+    Poly<dyno::shared_remote_storage, Remote> a{Counted{}};
+    Poly<dyno::shared_remote_storage, Remote> shared{a};
+    Poly<dyno::shared_remote_storage, Remote> b{Counted{}};
+    reset_counters();
+    a = b;
+    DYNO_CHECK(copy_assignments == 0);
+    DYNO_CHECK(a.unsafe_get<void>() == b.unsafe_get<void>());
+    DYNO_CHECK(shared.unsafe_get<void>() != b.unsafe_get<void>());
+  }
+}
@@ -0,0 +1,104 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/storage.hpp>
+
+#include <stdexcept>
+using namespace dyno::literals;
+
+
+// This test makes sure that copy-assigning and emplacing into a `dyno::poly`
+// leave it unchanged when constructing the new object throws, even with
+// storages that can reuse their memory.
+
+struct Concept : decltype(dyno::requires(
+  dyno::CopyConstructible{},
+  dyno::MoveConstructible{},
+  "value"_s = dyno::method<int () const>
+)) { };
+
+int live = 0;
+
+struct Thrower {
+  explicit Thrower(int v) : value{v} { ++live; }
+  Thrower(int, bool fail) : value{0} {
+    if (fail)
+      throw std::runtime_error{"construction"};
+    ++live;
+  }
+  Thrower(Thrower const&) : value{0} { throw std::runtime_error{"copy"}; }
+  Thrower(Thrower&& other) noexcept : value{other.value} { ++live; }
+  ~Thrower() { --live; }
+  int value;
+};
+
+struct Other {
+  int value;
+};
+
+template <>
+auto const dyno::concept_map<Concept, Thrower> = dyno::make_concept_map(
+  "value"_s = [](Thrower const& self) { return self.value; }
+);
+
+template <>
+auto const dyno::concept_map<Concept, Other> = dyno::make_concept_map(
+  "value"_s = [](Other const& self) { return self.value; }
+);
+
+static_assert(!dyno::storage_info_for<Thrower>.nothrow_copy_constructible);
+static_assert(dyno::storage_info_for<Other>.nothrow_copy_constructible);
+
+template <typename Storage>
+void test() {
+  using Poly = dyno::poly<Concept, Storage>;
+  live = 0;
+  {
+    Poly a{Other{1}};
+    Poly b{std::in_place_type<Thrower>, 2};
+    DYNO_CHECK(live == 1);
+
+    bool thrown = false;
+    try {
+      a = b;
+    } catch (std::runtime_error const&) {
+      thrown = true;
+    }
+    DYNO_CHECK(thrown);
+    DYNO_CHECK(live == 1);
+    DYNO_CHECK(a.template unsafe_get<Other>()->value == 1);
+    DYNO_CHECK(a.virtual_("value"_s)() == 1);
+
+    thrown = false;
+    try {
+      a.template emplace<Thrower>(3, true);
+    } catch (std::runtime_error const&) {
+      thrown = true;
+    }
+    DYNO_CHECK(thrown);
+    DYNO_CHECK(live == 1);
+    DYNO_CHECK(a.virtual_("value"_s)() == 1);
+
+    // When construction succeeds, the object is replaced.
+    a.template emplace<Thrower>(4, false);
+    DYNO_CHECK(live == 2);
+    DYNO_CHECK(a.virtual_("value"_s)() == 0);
+    a.template emplace<Other>(Other{5});
+    DYNO_CHECK(live == 1);
+    DYNO_CHECK(a.virtual_("value"_s)() == 5);
+  }
+  DYNO_CHECK(live == 0);
+}
+
+int main() {
+  test<dyno::remote_storage>();
+  test<dyno::sbo_storage<32>>();
+  test<dyno::local_storage<32>>();
+}
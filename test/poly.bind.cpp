@@ -0,0 +1,72 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+using namespace dyno::literals;
+
+
+// This test makes sure that `dyno::poly::bind` returns a callable that calls
+// the right function on the right object, and that it is no larger than a
+// function pointer and a pointer to the object.
+
+struct Concept : decltype(dyno::requires(
+  "a"_s = dyno::method<int (int)>,
+  "b"_s = dyno::method<int (int) const>,
+  "c"_s = dyno::function<int (dyno::T&, int)>,
+  "d"_s = dyno::function<int (dyno::T const*)>,
+  "e"_s = dyno::function<bool (dyno::T const&, dyno::T const&)>
+)) { };
+
+struct Foo { int value; };
+
+template <>
+auto const dyno::concept_map<Concept, Foo> = dyno::make_concept_map(
+  "a"_s = [](Foo& self, int i) { return self.value += i; },
+  "b"_s = [](Foo const& self, int i) { return self.value + i; },
+  "c"_s = [](Foo& self, int i) { return self.value *= i; },
+  "d"_s = [](Foo const* self) { return self->value; },
+  "e"_s = [](Foo const& a, Foo const& b) { return a.value == b.value; }
+);
+
+int main() {
+  {
+    dyno::poly<Concept> poly{Foo{1}};
+    auto a = poly.bind("a"_s);
+    static_assert(sizeof(a) <= 2 * sizeof(void*));
+    DYNO_CHECK(a(1) == 2);
+    DYNO_CHECK(a(3) == 5);
+    DYNO_CHECK(poly.unsafe_get<Foo>()->value == 5);
+  }
+  {
+    dyno::poly<Concept> const poly{Foo{1}};
+    auto b = poly.bind("b"_s);
+    static_assert(sizeof(b) <= 2 * sizeof(void*));
+    DYNO_CHECK(b(10) == 11);
+    DYNO_CHECK(b(20) == 21);
+  }
+  {
+    dyno::poly<Concept> poly{Foo{2}};
+    auto c = poly.bind("c"_s);
+    DYNO_CHECK(c(3) == 6);
+    DYNO_CHECK(c(3) == 18);
+  }
+  {
+    dyno::poly<Concept> const poly{Foo{4}};
+    auto d = poly.bind("d"_s);
+    DYNO_CHECK(d() == 4);
+  }
+  {
+    // Placeholders in the remaining parameters are still unerased from polys.
+    dyno::poly<Concept> const poly{Foo{4}};
+    dyno::poly<Concept> const same{Foo{4}};
+    dyno::poly<Concept> const other{Foo{5}};
+    auto e = poly.bind("e"_s);
+    DYNO_CHECK(e(same));
+    DYNO_CHECK(!e(other));
+  }
+}
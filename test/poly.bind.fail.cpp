@@ -0,0 +1,29 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+using namespace dyno::literals;
+
+
+// This test makes sure that we can't bind a non-const method to a const poly.
+
+struct Concept : decltype(dyno::requires(
+  "f"_s = dyno::method<int ()>
+)) { };
+
+struct Foo { };
+
+template <>
+auto const dyno::concept_map<Concept, Foo> = dyno::make_concept_map(
+  "f"_s = [](Foo&) { return 111; }
+);
+
+int main() {
+  dyno::poly<Concept> const poly{Foo{}};
+  // MESSAGE[dyno::poly::bind: Trying to bind a function taking a non-const placeholder]
+  auto f = poly.bind("f"_s);
+  (void)f;
+}
@@ -0,0 +1,30 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+using namespace dyno::literals;
+
+
+// This test makes sure that trying to bind a function without parameters
+// (here returning `void`) gives a proper diagnostic.
+
+struct Concept : decltype(dyno::requires(
+  "f"_s = dyno::function<void ()>
+)) { };
+
+struct Foo { };
+
+template <>
+auto const dyno::concept_map<Concept, Foo> = dyno::make_concept_map(
+  "f"_s = []() { }
+);
+
+int main() {
+  dyno::poly<Concept> poly{Foo{}};
+  // MESSAGE[dyno::poly::bind: Only methods and functions whose first parameter is a placeholder]
+  auto f = poly.bind("f"_s);
+  (void)f;
+}
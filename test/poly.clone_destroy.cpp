@@ -0,0 +1,127 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/storage.hpp>
+
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <string>
+using namespace dyno::literals;
+
+
+// This test makes sure that storages holding objects on the heap use the
+// `"clone"` and `"destroy"` functions when the concept provides them, and
+// that the default implementations of these functions work.
+
+struct Concept : decltype(dyno::requires(
+  dyno::CopyConstructible{},
+  dyno::Clonable{},
+  dyno::Destroyable{},
+  "value"_s = dyno::method<std::string () const>
+)) { };
+
+struct Big {
+  std::string value;
+  char padding[64] = {};
+};
+
+int clones = 0;
+int destroys = 0;
+
+template <>
+auto const dyno::concept_map<Concept, Big> = dyno::make_concept_map(
+  "clone"_s = [](Big const& other) -> void* {
+    ++clones;
+    return new (std::malloc(sizeof(Big))) Big(other);
+  },
+  "destroy"_s = [](Big& self) {
+    ++destroys;
+    self.~Big();
+    std::free(&self);
+  },
+  "value"_s = [](Big const& self) { return self.value; }
+);
+
+struct Small {
+  std::string value;
+};
+
+template <>
+auto const dyno::concept_map<Concept, Small> = dyno::make_concept_map(
+  "value"_s = [](Small const& self) { return self.value; }
+);
+
+// The default "clone" frees its memory when the copy constructor throws.
+struct Thrower {
+  Thrower() = default;
+  Thrower(Thrower const&) { throw std::runtime_error{"copy"}; }
+  Thrower(Thrower&&) noexcept = default;
+  char padding[64] = {};
+};
+
+template <>
+auto const dyno::concept_map<Concept, Thrower> = dyno::make_concept_map(
+  "value"_s = [](Thrower const&) { return std::string{"thrower"}; }
+);
+
+template <typename Storage>
+void test() {
+  clones = destroys = 0;
+  {
+    dyno::poly<Concept, Storage> a{Big{"big"}};
+    dyno::poly<Concept, Storage> b{a};
+    DYNO_CHECK(clones == 1);
+    DYNO_CHECK(b.virtual_("value"_s)() == "big");
+
+    // Assigning a small object to a poly holding a big object can't reuse
+    // the allocation, so the big object is destroyed.
+    b = dyno::poly<Concept, Storage>{Small{"small"}};
+    DYNO_CHECK(destroys == 1);
+    DYNO_CHECK(b.virtual_("value"_s)() == "small");
+  }
+  DYNO_CHECK(destroys == 2);
+
+  // The default "clone" and "destroy" are used for other types.
+  {
+    dyno::poly<Concept, Storage> a{Small{"small"}};
+    dyno::poly<Concept, Storage> b{a};
+    DYNO_CHECK(b.virtual_("value"_s)() == "small");
+  }
+  DYNO_CHECK(clones == 1);
+  DYNO_CHECK(destroys == 2);
+
+  {
+    dyno::poly<Concept, Storage> a{Thrower{}};
+    bool thrown = false;
+    try {
+      dyno::poly<Concept, Storage> b{a};
+    } catch (std::runtime_error const&) {
+      thrown = true;
+    }
+    DYNO_CHECK(thrown);
+    DYNO_CHECK(a.virtual_("value"_s)() == "thrower");
+  }
+}
+
+int main() {
+  test<dyno::remote_storage>();
+  test<dyno::sbo_storage<4>>();
+
+  // When the object is in the buffer, "clone" and "destroy" are not used.
+  clones = destroys = 0;
+  {
+    dyno::poly<Concept, dyno::sbo_storage<128>> a{Big{"big"}};
+    dyno::poly<Concept, dyno::sbo_storage<128>> b{a};
+    DYNO_CHECK(b.virtual_("value"_s)() == "big");
+  }
+  DYNO_CHECK(clones == 0);
+  DYNO_CHECK(destroys == 0);
+}
@@ -0,0 +1,98 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/storage.hpp>
+
+#include <string>
+#include <type_traits>
+#include <utility>
+using namespace dyno::literals;
+
+
+// This test makes sure that constructing a `dyno::poly` in place constructs
+// exactly one object in the storage, and works with types that are neither
+// copyable nor movable, and with aggregates.
+
+struct Concept : decltype(dyno::requires(
+  "value"_s = dyno::method<int () const>
+)) { };
+
+int constructions = 0;
+int destructions = 0;
+
+template <std::size_t Size>
+struct Immovable {
+  Immovable(int a, int b) : value{a + b} { ++constructions; }
+  Immovable(Immovable const&) = delete;
+  Immovable(Immovable&&) = delete;
+  ~Immovable() { ++destructions; }
+  int value;
+  char padding[Size];
+};
+
+struct Aggregate {
+  int value;
+  std::string name;
+};
+
+template <std::size_t Size>
+auto const dyno::concept_map<Concept, Immovable<Size>> = dyno::make_concept_map(
+  "value"_s = [](Immovable<Size> const& self) { return self.value; }
+);
+
+template <>
+auto const dyno::concept_map<Concept, Aggregate> = dyno::make_concept_map(
+  "value"_s = [](Aggregate const& self) { return self.value; }
+);
+
+template <typename Storage>
+void test() {
+  using Poly = dyno::poly<Concept, Storage>;
+
+  // Small objects
+  {
+    constructions = destructions = 0;
+    {
+      Poly poly{std::in_place_type<Immovable<1>>, 1, 2};
+      DYNO_CHECK(poly.virtual_("value"_s)() == 3);
+      DYNO_CHECK(constructions == 1);
+    }
+    DYNO_CHECK(destructions == 1);
+  }
+
+  // Aggregates
+  {
+    Poly poly{std::in_place_type<Aggregate>, 4, "four"};
+    DYNO_CHECK(poly.virtual_("value"_s)() == 4);
+    DYNO_CHECK(poly.template unsafe_get<Aggregate>()->name == "four");
+  }
+
+  // Objects that do not fit in a small buffer
+  if constexpr (Storage::can_store(dyno::storage_info_for<Immovable<64>>)) {
+    constructions = destructions = 0;
+    {
+      Poly poly{std::in_place_type<Immovable<64>>, 5, 6};
+      DYNO_CHECK(poly.virtual_("value"_s)() == 11);
+      DYNO_CHECK(constructions == 1);
+    }
+    DYNO_CHECK(destructions == 1);
+  }
+}
+
+int main() {
+  test<dyno::remote_storage>();
+  test<dyno::sbo_storage<16>>();
+  test<dyno::shared_remote_storage>();
+  test<dyno::local_storage<64>>();
+  test<dyno::fallback_storage<dyno::local_storage<16>, dyno::remote_storage>>();
+
+  // The in-place constructor is explicit.
+  static_assert(!std::is_convertible<std::in_place_type_t<Aggregate>,
+                                     dyno::poly<Concept>>::value, "");
+}
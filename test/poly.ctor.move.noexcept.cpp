@@ -0,0 +1,79 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/storage.hpp>
+
+#include <type_traits>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This test makes sure that `dyno::poly`'s move constructor is `noexcept`
+// whenever the storage allows it, so that containers of `poly`s don't copy
+// them when they grow.
+
+struct Concept : decltype(dyno::requires(
+  dyno::CopyConstructible{}
+)) { };
+
+template <typename Storage>
+using Poly = dyno::poly<Concept, Storage>;
+
+static_assert(std::is_nothrow_move_constructible<Poly<dyno::remote_storage>>{}, "");
+static_assert(std::is_nothrow_move_constructible<Poly<dyno::sbo_storage<16>>>{}, "");
+static_assert(std::is_nothrow_move_constructible<Poly<dyno::shared_remote_storage>>{}, "");
+static_assert(std::is_nothrow_move_constructible<Poly<dyno::non_owning_storage>>{}, "");
+static_assert(std::is_nothrow_move_constructible<
+  Poly<dyno::fallback_storage<dyno::sbo_storage<16>, dyno::remote_storage>>
+>{}, "");
+
+// Objects held in a local storage must be moved when the storage is moved.
+static_assert(!std::is_nothrow_move_constructible<Poly<dyno::local_storage<16>>>{}, "");
+static_assert(!std::is_nothrow_move_constructible<
+  Poly<dyno::fallback_storage<dyno::local_storage<16>, dyno::remote_storage>>
+>{}, "");
+
+int copies = 0;
+
+struct Small {
+  Small() = default;
+  Small(Small const&) noexcept { ++copies; }
+  Small(Small&&) noexcept { }
+};
+
+struct ThrowingMove {
+  ThrowingMove() = default;
+  ThrowingMove(ThrowingMove const&) { ++copies; }
+  ThrowingMove(ThrowingMove&&) { }
+};
+
+int main() {
+  // Objects whose move constructor may throw are stored on the heap.
+  {
+    static_assert(dyno::sbo_storage<16>::can_store(dyno::storage_info_for<Small>), "");
+    static_assert(!dyno::sbo_storage<16>::can_store(dyno::storage_info_for<ThrowingMove>), "");
+
+    Poly<dyno::sbo_storage<16>> poly{ThrowingMove{}};
+    ThrowingMove* object = poly.unsafe_get<ThrowingMove>();
+    Poly<dyno::sbo_storage<16>> moved{std::move(poly)};
+    DYNO_CHECK(moved.unsafe_get<ThrowingMove>() == object);
+  }
+
+  // Growing a vector does not copy its elements.
+  {
+    std::vector<Poly<dyno::sbo_storage<16>>> polys;
+    for (int i = 0; i != 100; ++i) {
+      if (i % 2 == 0)
+        polys.emplace_back(Small{});
+      else
+        polys.emplace_back(ThrowingMove{});
+    }
+    DYNO_CHECK(copies == 0);
+  }
+}
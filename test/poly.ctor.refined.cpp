@@ -0,0 +1,109 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/storage.hpp>
+#include <dyno/vtable.hpp>
+
+#include <utility>
+using namespace dyno::literals;
+
+
+// This test makes sure that a `dyno::poly` can be converted to a `dyno::poly`
+// of a concept that its concept refines, and that converting by moving does
+// not copy or move the object held by the original `poly`.
+
+struct Base : decltype(dyno::requires(
+  dyno::CopyConstructible{},
+  "f"_s = dyno::method<int () const>
+)) { };
+
+struct Other : decltype(dyno::requires(
+  "h"_s = dyno::method<int () const>
+)) { };
+
+struct Derived : decltype(dyno::requires(
+  Base{},
+  "g"_s = dyno::method<int () const>,
+  Other{}
+)) { };
+
+int copies = 0;
+int moves = 0;
+
+struct Foo {
+  Foo() = default;
+  Foo(Foo const&) { ++copies; }
+  Foo(Foo&&) { ++moves; }
+};
+
+template <>
+auto const dyno::concept_map<Derived, Foo> = dyno::make_concept_map(
+  "f"_s = [](Foo const&) { return 111; },
+  "g"_s = [](Foo const&) { return 222; },
+  "h"_s = [](Foo const&) { return 333; }
+);
+
+int main() {
+  // Converting by moving with a remote vtable and remote storage does not
+  // touch the object.
+  {
+    dyno::poly<Derived> derived{Foo{}};
+    copies = moves = 0;
+    dyno::poly<Base> base{std::move(derived)};
+    DYNO_CHECK(copies == 0);
+    DYNO_CHECK(moves == 0);
+    DYNO_CHECK(base.virtual_("f"_s)() == 111);
+
+    // The converted poly is a regular poly.
+    dyno::poly<Base> copy{base};
+    DYNO_CHECK(copies == 1);
+    DYNO_CHECK(copy.virtual_("f"_s)() == 111);
+  }
+
+  // Converting by copying copies the object.
+  {
+    dyno::poly<Derived> const derived{Foo{}};
+    copies = moves = 0;
+    dyno::poly<Base> base = derived;
+    DYNO_CHECK(copies == 1);
+    DYNO_CHECK(base.virtual_("f"_s)() == 111);
+    DYNO_CHECK(derived.virtual_("g"_s)() == 222);
+  }
+
+  // With a local vtable, any refined concept can be converted to.
+  {
+    using VTable = dyno::vtable<dyno::local<dyno::everything>>;
+    dyno::poly<Derived, dyno::remote_storage, VTable> derived{Foo{}};
+    copies = moves = 0;
+    dyno::poly<Other, dyno::remote_storage, VTable> other{std::move(derived)};
+    DYNO_CHECK(copies == 0);
+    DYNO_CHECK(moves == 0);
+    DYNO_CHECK(other.virtual_("h"_s)() == 333);
+  }
+
+  // With storage that holds the object inline, the object is moved as usual.
+  {
+    dyno::poly<Derived, dyno::local_storage<16>> derived{Foo{}};
+    copies = moves = 0;
+    dyno::poly<Base, dyno::local_storage<16>> base{std::move(derived)};
+    DYNO_CHECK(copies == 0);
+    DYNO_CHECK(moves == 1);
+    DYNO_CHECK(base.virtual_("f"_s)() == 111);
+  }
+
+  // Conversions can be chained through intermediate concepts.
+  {
+    dyno::poly<Derived> derived{Foo{}};
+    dyno::poly<Base> base{std::move(derived)};
+    dyno::poly<dyno::CopyConstructible> copyable{std::move(base)};
+    dyno::poly<dyno::CopyConstructible> copy{copyable};
+    (void)copy;
+  }
+}
@@ -0,0 +1,40 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+
+#include <utility>
+using namespace dyno::literals;
+
+
+// This test makes sure that we get a nice error when trying to convert a
+// `dyno::poly` to a `dyno::poly` of a concept that is refined, but not
+// first, when the vtable is remote. Doing so would require creating a
+// new vtable.
+
+struct A : decltype(dyno::requires(
+  "f"_s = dyno::function<void (dyno::T&)>
+)) { };
+
+struct B : decltype(dyno::requires(
+  "g"_s = dyno::function<void (dyno::T&)>
+)) { };
+
+struct C : decltype(dyno::requires(A{}, B{})) { };
+
+struct Foo { };
+
+template <>
+auto const dyno::concept_map<C, Foo> = dyno::make_concept_map(
+  "f"_s = [](Foo&) { },
+  "g"_s = [](Foo&) { }
+);
+
+int main() {
+  dyno::poly<C> c{Foo{}};
+  // MESSAGE[dyno::remote_vtable: Trying to convert from a remote vtable whose layout is not compatible]
+  dyno::poly<B> b{std::move(c)};
+}
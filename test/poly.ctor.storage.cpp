@@ -0,0 +1,90 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/storage.hpp>
+
+#include <utility>
+using namespace dyno::literals;
+
+
+// This test makes sure that moving a `dyno::poly` into a `dyno::poly` with
+// a different storage policy steals the heap allocation when there is one,
+// and only moves the object otherwise.
+
+struct Concept : decltype(dyno::requires(dyno::MoveConstructible{})) { };
+
+int moves = 0;
+
+template <std::size_t Size>
+struct Object {
+  Object() = default;
+  Object(Object const&) = delete;
+  Object(Object&&) noexcept { ++moves; }
+  char data[Size];
+};
+
+using Small = Object<8>;
+using Big = Object<64>;
+
+int main() {
+  // sbo_storage (on the heap) -> remote_storage
+  {
+    dyno::poly<Concept, dyno::sbo_storage<16>> sbo{Big{}};
+    Big* object = sbo.unsafe_get<Big>();
+    moves = 0;
+    dyno::poly<Concept, dyno::remote_storage> remote{std::move(sbo)};
+    DYNO_CHECK(moves == 0);
+    DYNO_CHECK(remote.unsafe_get<Big>() == object);
+  }
+
+  // sbo_storage (in the buffer) -> remote_storage
+  {
+    dyno::poly<Concept, dyno::sbo_storage<16>> sbo{Small{}};
+    moves = 0;
+    dyno::poly<Concept, dyno::remote_storage> remote{std::move(sbo)};
+    DYNO_CHECK(moves == 1);
+  }
+
+  // remote_storage -> sbo_storage, even when the object would fit the buffer
+  {
+    dyno::poly<Concept, dyno::remote_storage> remote{Small{}};
+    Small* object = remote.unsafe_get<Small>();
+    moves = 0;
+    dyno::poly<Concept, dyno::sbo_storage<16>> sbo{std::move(remote)};
+    DYNO_CHECK(moves == 0);
+    DYNO_CHECK(sbo.unsafe_get<Small>() == object);
+
+    // The resulting poly is a regular poly.
+    dyno::poly<Concept, dyno::sbo_storage<16>> moved{std::move(sbo)};
+    DYNO_CHECK(moves == 0);
+    DYNO_CHECK(moved.unsafe_get<Small>() == object);
+  }
+
+  // sbo_storage -> sbo_storage with a different buffer size
+  {
+    dyno::poly<Concept, dyno::sbo_storage<8>> small_buffer{Big{}};
+    Big* object = small_buffer.unsafe_get<Big>();
+    moves = 0;
+    dyno::poly<Concept, dyno::sbo_storage<128>> big_buffer{std::move(small_buffer)};
+    DYNO_CHECK(moves == 0);
+    DYNO_CHECK(big_buffer.unsafe_get<Big>() == object);
+  }
+  {
+    dyno::poly<Concept, dyno::sbo_storage<128>> big_buffer{Big{}};
+    moves = 0;
+    dyno::poly<Concept, dyno::sbo_storage<16>> small_buffer{std::move(big_buffer)};
+    DYNO_CHECK(moves == 1);
+  }
+  {
+    dyno::poly<Concept, dyno::sbo_storage<16>> small_buffer{Small{}};
+    moves = 0;
+    dyno::poly<Concept, dyno::sbo_storage<128>> big_buffer{std::move(small_buffer)};
+    DYNO_CHECK(moves == 1);
+  }
+}
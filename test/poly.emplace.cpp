@@ -0,0 +1,109 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/storage.hpp>
+#include <dyno/vtable.hpp>
+
+#include <cstring>
+using namespace dyno::literals;
+
+
+// This test makes sure that `dyno::poly::emplace` destroys the object held
+// by the poly and constructs a new one in place, updating the vtable.
+
+struct Concept : decltype(dyno::requires(
+  "value"_s = dyno::method<int () const>
+)) { };
+
+int destructions = 0;
+
+// The concept does not include `dyno::MoveConstructible`, so the constructor
+// used by `emplace` must not throw.
+struct Immovable {
+  explicit Immovable(int v) noexcept : value{v} { }
+  Immovable(Immovable const&) = delete;
+  Immovable(Immovable&&) = delete;
+  ~Immovable() { ++destructions; }
+  int value;
+};
+
+// With storages that can't reuse their memory, the concept must include
+// `dyno::MoveConstructible`, so the objects must be movable.
+struct MovableConcept : decltype(dyno::requires(
+  dyno::MoveConstructible{},
+  Concept{}
+)) { };
+
+// Moved-from objects are not counted, since the storage may move objects.
+struct Movable {
+  explicit Movable(int v) noexcept : value{v} { }
+  Movable(Movable&& other) noexcept : value{other.value} { other.value = 0; }
+  ~Movable() { if (value != 0) ++destructions; }
+  int value;
+};
+
+struct Aggregate {
+  char const* name;
+  char padding[64] = {};
+};
+
+template <>
+auto const dyno::concept_map<Concept, Immovable> = dyno::make_concept_map(
+  "value"_s = [](Immovable const& self) { return self.value; }
+);
+
+template <>
+auto const dyno::concept_map<Concept, Movable> = dyno::make_concept_map(
+  "value"_s = [](Movable const& self) { return self.value; }
+);
+
+template <>
+auto const dyno::concept_map<Concept, Aggregate> = dyno::make_concept_map(
+  "value"_s = [](Aggregate const& self) { return static_cast<int>(std::strlen(self.name)); }
+);
+
+template <typename C, typename Object, typename Storage, typename VTablePolicy>
+void test() {
+  using Poly = dyno::poly<C, Storage, VTablePolicy>;
+
+  destructions = 0;
+  {
+    Poly poly{std::in_place_type<Object>, 1};
+    DYNO_CHECK(poly.virtual_("value"_s)() == 1);
+
+    Object& object = poly.template emplace<Object>(2);
+    DYNO_CHECK(destructions == 1);
+    DYNO_CHECK(&object == poly.template unsafe_get<Object>());
+    DYNO_CHECK(poly.virtual_("value"_s)() == 2);
+
+    Aggregate& aggregate = poly.template emplace<Aggregate>("three");
+    DYNO_CHECK(destructions == 2);
+    DYNO_CHECK(&aggregate == poly.template unsafe_get<Aggregate>());
+    DYNO_CHECK(poly.virtual_("value"_s)() == 5);
+
+    poly.template emplace<Object>(4);
+    DYNO_CHECK(destructions == 2);
+    DYNO_CHECK(poly.virtual_("value"_s)() == 4);
+  }
+  DYNO_CHECK(destructions == 3);
+}
+
+int main() {
+  using Remote = dyno::vtable<dyno::remote<dyno::everything>>;
+  using Local = dyno::vtable<dyno::local<dyno::everything>>;
+  using Joined = dyno::vtable<dyno::local<dyno::only<decltype("value"_s)>>,
+                              dyno::remote<dyno::everything_else>>;
+
+  test<Concept, Immovable, dyno::remote_storage, Remote>();
+  test<Concept, Immovable, dyno::sbo_storage<16>, Remote>();
+  test<MovableConcept, Movable, dyno::shared_remote_storage, Remote>();
+  test<MovableConcept, Movable, dyno::fallback_storage<dyno::local_storage<16>, dyno::remote_storage>, Remote>();
+  test<Concept, Immovable, dyno::sbo_storage<16>, Local>();
+  test<Concept, Immovable, dyno::sbo_storage<16>, Joined>();
+}
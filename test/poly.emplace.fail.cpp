@@ -0,0 +1,32 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+using namespace dyno::literals;
+
+
+// This test makes sure that we can't emplace an object whose constructor may
+// throw when the poly can't be left unchanged if it does.
+
+struct Concept : decltype(dyno::requires(
+  "f"_s = dyno::method<int () const>
+)) { };
+
+struct Foo {
+  explicit Foo(int) { }
+  Foo(Foo&&) = delete;
+};
+
+template <>
+auto const dyno::concept_map<Concept, Foo> = dyno::make_concept_map(
+  "f"_s = [](Foo const&) { return 111; }
+);
+
+int main() {
+  dyno::poly<Concept> poly{std::in_place_type<Foo>, 1};
+  // MESSAGE[dyno::poly::emplace: Trying to emplace an object in a poly whose concept does not include dyno::MoveConstructible]
+  poly.emplace<Foo>(2);
+}
@@ -0,0 +1,105 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/storage.hpp>
+#include <dyno/vtable.hpp>
+
+#include <type_traits>
+#include <utility>
+using namespace dyno::literals;
+
+
+// This test makes sure that swapping `dyno::poly`s holding objects of the
+// same type in a local buffer uses the swap of that type when the concept
+// includes `dyno::Swappable`, and moves the objects otherwise.
+
+struct Concept : decltype(dyno::requires(
+  dyno::MoveConstructible{},
+  dyno::Swappable{}
+)) { };
+
+int moves = 0;
+int swaps = 0;
+
+struct Counted {
+  explicit Counted(int v) : value{v} { }
+  Counted(Counted&& other) noexcept : value{other.value} { ++moves; }
+  friend void swap(Counted& a, Counted& b) { ++swaps; std::swap(a.value, b.value); }
+  int value;
+};
+
+struct Other {
+  int value;
+};
+
+struct Fixed {
+  int const value;
+};
+
+template <typename Storage, typename VTable>
+void test(int expected_swaps) {
+  using Poly = dyno::poly<Concept, Storage, VTable>;
+
+  // Same types
+  {
+    Poly a{Counted{1}};
+    Poly b{Counted{2}};
+    moves = swaps = 0;
+    a.swap(b);
+    DYNO_CHECK(swaps == expected_swaps);
+    DYNO_CHECK(moves == (expected_swaps ? 0 : 3));
+    DYNO_CHECK(a.template unsafe_get<Counted>()->value == 2);
+    DYNO_CHECK(b.template unsafe_get<Counted>()->value == 1);
+  }
+
+  // Different types
+  {
+    Poly a{Counted{1}};
+    Poly b{Other{2}};
+    moves = swaps = 0;
+    a.swap(b);
+    DYNO_CHECK(swaps == 0);
+    DYNO_CHECK(a.template unsafe_get<Other>()->value == 2);
+    DYNO_CHECK(b.template unsafe_get<Counted>()->value == 1);
+  }
+}
+
+int main() {
+  using Remote = dyno::vtable<dyno::remote<dyno::everything>>;
+  using Local = dyno::vtable<dyno::local<dyno::everything>>;
+
+  test<dyno::sbo_storage<16>, Remote>(1);
+  test<dyno::local_storage<16>, Remote>(1);
+  test<dyno::fallback_storage<dyno::local_storage<16>, dyno::remote_storage>, Remote>(1);
+
+  // A local vtable can't tell whether the types are the same.
+  test<dyno::sbo_storage<16>, Local>(0);
+
+  // Objects that are not swappable are moved, but still model the concept.
+  {
+    static_assert(!std::is_swappable<Fixed>::value);
+    static_assert(dyno::models<Concept, Fixed>);
+    dyno::poly<Concept, dyno::local_storage<16>> a{Fixed{1}};
+    dyno::poly<Concept, dyno::local_storage<16>> b{Fixed{2}};
+    a.swap(b);
+    DYNO_CHECK(a.unsafe_get<Fixed>()->value == 2);
+    DYNO_CHECK(b.unsafe_get<Fixed>()->value == 1);
+  }
+
+  // Swapping objects on the heap only swaps pointers.
+  {
+    dyno::poly<Concept> a{Counted{1}};
+    dyno::poly<Concept> b{Counted{2}};
+    moves = swaps = 0;
+    a.swap(b);
+    DYNO_CHECK(swaps == 0);
+    DYNO_CHECK(moves == 0);
+    DYNO_CHECK(a.unsafe_get<Counted>()->value == 2);
+  }
+}
@@ -0,0 +1,149 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/algorithm.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/poly_collection.hpp>
+#include <dyno/vtable.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This test makes sure that batch functions can be defined in concept maps
+// either over an array of objects or over a single object, and that they are
+// called once per array by `dyno::poly_collection`.
+
+struct Particle : decltype(dyno::requires(
+  "advance"_s = dyno::batch_function<void (dyno::T*, std::size_t, float)>,
+  "sum"_s = dyno::batch_function<void (dyno::T const*, std::size_t, float&) noexcept>,
+  "log"_s = dyno::batch_function<void (dyno::T const*, std::size_t, std::string, std::vector<std::string>&)>
+)) { };
+
+// The batch functions are implemented over arrays.
+struct Dust {
+  float x;
+  static std::vector<std::size_t> batches;
+};
+std::vector<std::size_t> Dust::batches;
+
+// The batch functions are implemented over single objects.
+struct Spark { float x; };
+
+template <>
+auto const dyno::concept_map<Particle, Dust> = dyno::make_concept_map(
+  "advance"_s = [](Dust* first, std::size_t size, float dt) {
+    Dust::batches.push_back(size);
+    for (std::size_t i = 0; i != size; ++i)
+      first[i].x += dt;
+  },
+  "sum"_s = [](Dust const* first, std::size_t size, float& total) noexcept {
+    for (std::size_t i = 0; i != size; ++i)
+      total += first[i].x;
+  },
+  "log"_s = [](Dust const* first, std::size_t size, std::string const& prefix,
+               std::vector<std::string>& out) {
+    for (std::size_t i = 0; i != size; ++i)
+      out.push_back(prefix + "dust" + std::to_string(int(first[i].x)));
+  }
+);
+
+template <>
+auto const dyno::concept_map<Particle, Spark> = dyno::make_concept_map(
+  "advance"_s = [](Spark& self, float dt) { self.x += 2 * dt; },
+  "sum"_s = [](Spark const& self, float& total) noexcept { total += self.x; },
+  "log"_s = [](Spark const& self, std::string const& prefix, std::vector<std::string>& out) {
+    out.push_back(prefix + "spark" + std::to_string(int(self.x)));
+  }
+);
+
+template <typename VTablePolicy>
+void test() {
+  Dust::batches.clear();
+
+  // Through a single poly, the batch function is applied to one object.
+  {
+    using Poly = dyno::poly<Particle, dyno::remote_storage, VTablePolicy>;
+    Poly dust{Dust{1}};
+    Poly spark{Spark{1}};
+    dust.virtual_("advance"_s)(1.0f);
+    spark.virtual_("advance"_s)(1.0f);
+    DYNO_CHECK(dust.template unsafe_get<Dust>()->x == 2);
+    DYNO_CHECK(spark.template unsafe_get<Spark>()->x == 3);
+    DYNO_CHECK((Dust::batches == std::vector<std::size_t>{1}));
+
+    Poly const& cspark = spark;
+    float total = 0;
+    auto sum = cspark.virtual_("sum"_s);
+    static_assert(noexcept(sum(total)));
+    sum(total);
+    dust.bind("sum"_s)(total);
+    DYNO_CHECK(total == 5);
+
+    std::vector<std::string> out;
+    cspark.virtual_("log"_s)("a", out);
+    DYNO_CHECK((out == std::vector<std::string>{"aspark3"}));
+  }
+
+  // Through `dyno::invoke_each`, the batch function is applied to each object.
+  {
+    using Poly = dyno::poly<Particle, dyno::remote_storage, VTablePolicy>;
+    Dust::batches.clear();
+    std::vector<Poly> particles;
+    particles.emplace_back(Dust{0});
+    particles.emplace_back(Dust{1});
+    particles.emplace_back(Spark{2});
+    dyno::invoke_each(particles, "advance"_s, 1.0f);
+    DYNO_CHECK((Dust::batches == std::vector<std::size_t>{1, 1}));
+    std::vector<std::string> out;
+    dyno::invoke_each(particles, "log"_s, "", out);
+    DYNO_CHECK((out == std::vector<std::string>{"dust1", "dust2", "spark4"}));
+  }
+
+  // Through `dyno::poly_collection`, the batch function is applied to all the
+  // objects of a segment at once.
+  {
+    using Collection = dyno::poly_collection<Particle, VTablePolicy>;
+    Dust::batches.clear();
+    Collection particles;
+    for (int i = 0; i != 10; ++i) {
+      particles.insert(Dust{float(i)});
+      if (i % 2 == 0)
+        particles.insert(Spark{float(i)});
+    }
+    particles.invoke_each("advance"_s, 1.0f);
+    DYNO_CHECK((Dust::batches == std::vector<std::size_t>{10}));
+    DYNO_CHECK(particles.template begin<Dust>()[9].x == 10);
+    DYNO_CHECK(particles.template begin<Spark>()[4].x == 10);
+
+    Collection const& cparticles = particles;
+    float total = 0;
+    cparticles.invoke_each("sum"_s, total);
+    DYNO_CHECK(total == (1 + 10) * 10 / 2 + (2 + 4 + 6 + 8 + 10));
+
+    // The arguments are shared by all the objects.
+    std::vector<std::string> out;
+    std::string prefix = "p";
+    cparticles.invoke_each("log"_s, prefix, out);
+    DYNO_CHECK(out.size() == 15);
+    DYNO_CHECK(out.front() == "pdust1");
+    DYNO_CHECK(out.back() == "pspark10");
+
+    // Empty segments are skipped.
+    particles.clear();
+    particles.invoke_each("advance"_s, 1.0f);
+    DYNO_CHECK((Dust::batches == std::vector<std::size_t>{10}));
+  }
+}
+
+int main() {
+  test<dyno::vtable<dyno::remote<dyno::everything>>>();
+  test<dyno::vtable<dyno::local<dyno::everything>>>();
+}
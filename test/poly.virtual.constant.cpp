@@ -0,0 +1,93 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/vtable.hpp>
+
+#include <boost/hana/integral_constant.hpp>
+
+#include <type_traits>
+using namespace dyno::literals;
+
+
+// This test makes sure that constants can be stored in vtables and accessed
+// through `dyno::poly`, and that the builtin `"storage_info"` constant holds
+// the right information.
+
+enum class Kind { circle, square };
+
+struct Shape : decltype(dyno::requires(
+  "kind"_s = dyno::constant<Kind>,
+  "priority"_s = dyno::constant<int>,
+  "area"_s = dyno::method<double () const>
+)) { };
+
+struct Circle { double r; };
+struct Square { double side; };
+
+template <>
+auto const dyno::concept_map<Shape, Circle> = dyno::make_concept_map(
+  "kind"_s = std::integral_constant<Kind, Kind::circle>{},
+  "priority"_s = std::integral_constant<int, 3>{},
+  "area"_s = [](Circle const& c) { return 3 * c.r * c.r; }
+);
+
+template <>
+auto const dyno::concept_map<Shape, Square> = dyno::make_concept_map(
+  "kind"_s = std::integral_constant<Kind, Kind::square>{},
+  "priority"_s = boost::hana::int_c<7>,
+  "area"_s = [](Square const& s) { return s.side * s.side; }
+);
+
+template <typename VTablePolicy>
+void test() {
+  using Poly = dyno::poly<Shape, dyno::remote_storage, VTablePolicy>;
+
+  Poly circle{Circle{1.0}};
+  Poly square{Square{2.0}};
+  static_assert(std::is_same<decltype(circle.virtual_("kind"_s)), Kind>{});
+  static_assert(std::is_same<decltype(circle.virtual_("priority"_s)), int>{});
+
+  DYNO_CHECK(circle.virtual_("kind"_s) == Kind::circle);
+  DYNO_CHECK(square.virtual_("kind"_s) == Kind::square);
+  DYNO_CHECK(circle.virtual_("priority"_s) == 3);
+  DYNO_CHECK(square.virtual_("priority"_s) == 7);
+  DYNO_CHECK(circle.virtual_("area"_s)() == 3.0);
+  DYNO_CHECK(square.virtual_("area"_s)() == 4.0);
+
+  // Constants follow the object when polys are moved and swapped.
+  Poly moved{std::move(square)};
+  DYNO_CHECK(moved.virtual_("kind"_s) == Kind::square);
+  swap(moved, circle);
+  DYNO_CHECK(moved.virtual_("kind"_s) == Kind::circle);
+  DYNO_CHECK(circle.virtual_("priority"_s) == 7);
+}
+
+// The vtables holding constants can still be built at compile-time.
+using LocalVTable = dyno::vtable<dyno::local<dyno::everything>>::apply<
+  decltype(dyno::requires(dyno::Storable{}, Shape{}))
+>;
+constexpr LocalVTable constexpr_vtable{
+  dyno::complete_concept_map<decltype(dyno::requires(dyno::Storable{}, Shape{})), Circle>(
+    dyno::concept_map<Shape, Circle>
+  )
+};
+static_assert(constexpr_vtable["kind"_s] == Kind::circle);
+static_assert(constexpr_vtable["priority"_s] == 3);
+static_assert(constexpr_vtable["storage_info"_s].size == sizeof(Circle));
+static_assert(constexpr_vtable["storage_info"_s].alignment == alignof(Circle));
+
+int main() {
+  test<dyno::vtable<dyno::remote<dyno::everything>>>();
+  test<dyno::vtable<dyno::local<dyno::everything>>>();
+  test<dyno::vtable<
+    dyno::local<dyno::only<decltype("kind"_s)>>,
+    dyno::remote<dyno::everything_else>
+  >>();
+}
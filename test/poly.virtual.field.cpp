@@ -0,0 +1,90 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/storage.hpp>
+#include <dyno/vtable.hpp>
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+using namespace dyno::literals;
+
+
+// This test makes sure that fields can be accessed through `dyno::poly`,
+// and that they refer to the right member of the object held by the poly.
+
+struct Entity : decltype(dyno::requires(
+  "id"_s = dyno::field<int>,
+  "name"_s = dyno::field<std::string>
+)) { };
+
+struct Player {
+  double health;
+  int id;
+  std::string name;
+};
+
+struct Monster {
+  std::string name;
+  char padding[40] = {};
+  int id;
+};
+
+template <>
+auto const dyno::concept_map<Entity, Player> = dyno::make_concept_map(
+  "id"_s = DYNO_FIELD(Player, id),
+  "name"_s = DYNO_FIELD(Player, name)
+);
+
+template <>
+auto const dyno::concept_map<Entity, Monster> = dyno::make_concept_map(
+  "id"_s = DYNO_FIELD(Monster, id),
+  "name"_s = DYNO_FIELD(Monster, name)
+);
+
+template <typename Storage, typename VTablePolicy>
+void test() {
+  using Poly = dyno::poly<Entity, Storage, VTablePolicy>;
+
+  Poly player{Player{100.0, 1, "player"}};
+  Poly monster{Monster{"monster", {}, 2}};
+  Poly const& cplayer = player;
+
+  static_assert(std::is_same<decltype(player.virtual_("id"_s)), int&>{});
+  static_assert(std::is_same<decltype(cplayer.virtual_("id"_s)), int const&>{});
+
+  DYNO_CHECK(player.virtual_("id"_s) == 1);
+  DYNO_CHECK(player.virtual_("name"_s) == "player");
+  DYNO_CHECK(cplayer.virtual_("id"_s) == 1);
+  DYNO_CHECK(monster.virtual_("id"_s) == 2);
+  DYNO_CHECK(monster.virtual_("name"_s) == "monster");
+
+  // Fields can be modified through a non-const poly.
+  player.virtual_("id"_s) = 10;
+  monster.virtual_("name"_s) += "!";
+  DYNO_CHECK(player.template unsafe_get<Player>()->id == 10);
+  DYNO_CHECK(player.template unsafe_get<Player>()->health == 100.0);
+  DYNO_CHECK(monster.template unsafe_get<Monster>()->name == "monster!");
+
+  // Fields can be read through a non-const `poly_cref`, as const references.
+  {
+    Player const object{50.0, 3, "cref"};
+    dyno::poly_cref<Entity, VTablePolicy> ref{object};
+    static_assert(std::is_same<decltype(ref.virtual_("id"_s)), int const&>{});
+    DYNO_CHECK(ref.virtual_("id"_s) == 3);
+    DYNO_CHECK(ref.virtual_("name"_s) == "cref");
+    DYNO_CHECK(&ref.virtual_("id"_s) == &object.id);
+  }
+}
+
+int main() {
+  test<dyno::remote_storage, dyno::vtable<dyno::remote<dyno::everything>>>();
+  test<dyno::sbo_storage<16>, dyno::vtable<dyno::remote<dyno::everything>>>();
+  test<dyno::local_storage<96>, dyno::vtable<dyno::local<dyno::everything>>>();
+}
@@ -0,0 +1,113 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/macro.hpp>
+#include <dyno/poly.hpp>
+
+#include <string>
+#include <utility>
+using namespace dyno::literals;
+
+
+// This test makes sure that arguments passed by value to functions called
+// through `dyno::poly` are copied (or moved) only once, regardless of the
+// number of layers between the caller and the function in the concept map.
+
+int copies = 0;
+int moves = 0;
+
+struct Counter {
+  Counter() = default;
+  Counter(Counter const&) { ++copies; }
+  Counter(Counter&&) { ++moves; }
+  std::string payload = "payload";
+};
+
+void reset() { copies = moves = 0; }
+
+struct Concept : decltype(dyno::requires(
+  "by_value"_s = dyno::method<int (Counter) const>,
+  "by_ref"_s = dyno::method<int (Counter) const>,
+  "function"_s = dyno::function<int (dyno::T const&, Counter)>
+)) { };
+
+struct Foo { };
+
+template <>
+auto const dyno::concept_map<Concept, Foo> = dyno::make_concept_map(
+  "by_value"_s = [](Foo const&, Counter c) { return static_cast<int>(c.payload.size()); },
+  "by_ref"_s = [](Foo const&, Counter const& c) { return static_cast<int>(c.payload.size()); },
+  "function"_s = [](Foo const&, Counter c) { return static_cast<int>(c.payload.size()); }
+);
+
+DYNO_INTERFACE(Interface,
+  (f, int (Counter) const)
+);
+
+struct Bar {
+  int f(Counter c) const { return static_cast<int>(c.payload.size()); }
+};
+
+int main() {
+  dyno::poly<Concept> poly{Foo{}};
+  Counter counter;
+
+  // When the function in the concept map takes its parameter by value, an
+  // lvalue is copied once and then moved into the parameter, and an rvalue
+  // is only moved into the parameter.
+  {
+    reset();
+    DYNO_CHECK(poly.virtual_("by_value"_s)(counter) == 7);
+    DYNO_CHECK(copies == 1);
+    DYNO_CHECK(moves == 1);
+
+    reset();
+    DYNO_CHECK(poly.virtual_("by_value"_s)(Counter{}) == 7);
+    DYNO_CHECK(copies == 0);
+    DYNO_CHECK(moves == 1);
+
+    reset();
+    DYNO_CHECK(poly.virtual_("function"_s)(poly, std::move(counter)) == 7);
+    DYNO_CHECK(copies == 0);
+    DYNO_CHECK(moves == 1);
+
+    reset();
+    DYNO_CHECK(poly.bind("by_value"_s)(counter) == 7);
+    DYNO_CHECK(copies == 1);
+    DYNO_CHECK(moves == 1);
+  }
+
+  // When it takes its parameter by reference, an lvalue is copied once and
+  // an rvalue is neither copied nor moved.
+  {
+    reset();
+    DYNO_CHECK(poly.virtual_("by_ref"_s)(counter) == 7);
+    DYNO_CHECK(copies == 1);
+    DYNO_CHECK(moves == 0);
+
+    reset();
+    DYNO_CHECK(poly.virtual_("by_ref"_s)(Counter{}) == 7);
+    DYNO_CHECK(copies == 0);
+    DYNO_CHECK(moves == 0);
+  }
+
+  // Same thing through `DYNO_INTERFACE`.
+  {
+    Interface iface{Bar{}};
+
+    reset();
+    DYNO_CHECK(iface.f(counter) == 7);
+    DYNO_CHECK(copies == 1);
+    DYNO_CHECK(moves == 1);
+
+    reset();
+    DYNO_CHECK(iface.f(Counter{}) == 7);
+    DYNO_CHECK(copies == 0);
+    DYNO_CHECK(moves == 1);
+  }
+}
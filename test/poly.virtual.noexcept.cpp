@@ -0,0 +1,98 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+
+#include <utility>
+using namespace dyno::literals;
+
+
+// This test makes sure that functions declared `noexcept` in a concept are
+// `noexcept` all the way through: in the vtable, and when called through
+// `virtual_` and `bind`. Functions that are not declared `noexcept` must not
+// be reported as such.
+
+struct Concept : decltype(dyno::requires(
+  "f"_s = dyno::function<int (dyno::T const&, int) noexcept>,
+  "g"_s = dyno::function<int (dyno::T const&, int)>,
+  "a"_s = dyno::method<int (int) noexcept>,
+  "b"_s = dyno::method<int (int) & noexcept>,
+  "c"_s = dyno::method<int (int) && noexcept>,
+  "d"_s = dyno::method<int (int) const noexcept>,
+  "e"_s = dyno::method<int (int) const& noexcept>,
+  "h"_s = dyno::method<void () const>
+)) { };
+
+struct Foo { int value; };
+
+template <>
+auto const dyno::concept_map<Concept, Foo> = dyno::make_concept_map(
+  "f"_s = [](Foo const& foo, int i) noexcept { return foo.value + i; },
+  "g"_s = [](Foo const& foo, int i) { return foo.value - i; },
+  "a"_s = [](Foo& foo, int i) noexcept { return foo.value + i + 1; },
+  "b"_s = [](Foo& foo, int i) noexcept { return foo.value + i + 2; },
+  "c"_s = [](Foo&& foo, int i) noexcept { return foo.value + i + 3; },
+  "d"_s = [](Foo const& foo, int i) noexcept { return foo.value + i + 4; },
+  "e"_s = [](Foo const& foo, int i) noexcept { return foo.value + i + 5; },
+  "h"_s = [](Foo const&) { }
+);
+
+int main() {
+  using Poly = dyno::poly<Concept>;
+  Poly poly{Foo{10}};
+  Poly const& cpoly = poly;
+
+  // The function pointers stored in the vtable
+  {
+    using F = decltype(dyno::concept_map<Concept, Foo>["f"_s]);
+    static_assert(noexcept(std::declval<F>()(std::declval<Foo const&>(), 0)));
+    using G = decltype(dyno::concept_map<Concept, Foo>["g"_s]);
+    static_assert(!noexcept(std::declval<G>()(std::declval<Foo const&>(), 0)));
+  }
+
+  // dyno::function
+  {
+    auto f = poly.virtual_("f"_s);
+    auto g = poly.virtual_("g"_s);
+    static_assert(noexcept(f(poly, 1)));
+    static_assert(!noexcept(g(poly, 1)));
+    DYNO_CHECK(poly.virtual_("f"_s)(poly, 1) == 11);
+    DYNO_CHECK(poly.virtual_("g"_s)(poly, 1) == 9);
+  }
+
+  // dyno::method
+  {
+    auto a = poly.virtual_("a"_s);
+    auto b = poly.virtual_("b"_s);
+    auto c = std::move(poly).virtual_("c"_s);
+    auto d = cpoly.virtual_("d"_s);
+    auto e = cpoly.virtual_("e"_s);
+    auto h = cpoly.virtual_("h"_s);
+    static_assert(noexcept(a(1)));
+    static_assert(noexcept(b(1)));
+    static_assert(noexcept(c(1)));
+    static_assert(noexcept(d(1)));
+    static_assert(noexcept(e(1)));
+    static_assert(!noexcept(h()));
+    DYNO_CHECK(poly.virtual_("a"_s)(1) == 12);
+    DYNO_CHECK(poly.virtual_("b"_s)(1) == 13);
+    DYNO_CHECK(std::move(poly).virtual_("c"_s)(1) == 14);
+    DYNO_CHECK(cpoly.virtual_("d"_s)(1) == 15);
+    DYNO_CHECK(cpoly.virtual_("e"_s)(1) == 16);
+  }
+
+  // bind
+  {
+    auto f = poly.bind("f"_s);
+    auto g = poly.bind("g"_s);
+    static_assert(noexcept(f(1)));
+    static_assert(!noexcept(g(1)));
+    DYNO_CHECK(poly.bind("f"_s)(1) == 11);
+    DYNO_CHECK(poly.bind("g"_s)(1) == 9);
+  }
+}
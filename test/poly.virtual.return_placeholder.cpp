@@ -0,0 +1,144 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/storage.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+using namespace dyno::literals;
+
+
+// This test makes sure that functions returning `dyno::T` by value construct
+// their result directly inside the storage of the `poly` they return, and
+// that the resulting `poly` uses the vtable of the `poly` they were called on.
+
+int constructions = 0;
+int copies = 0;
+int moves = 0;
+
+void reset() { constructions = copies = moves = 0; }
+
+template <std::size_t Padding>
+struct Counter {
+  explicit Counter(int v) : value{v} { ++constructions; }
+  Counter(Counter const& other) : value{other.value} { ++copies; }
+  Counter(Counter&& other) noexcept : value{other.value} { ++moves; }
+  int value;
+  char padding[Padding];
+};
+
+using Small = Counter<1>;
+using Large = Counter<64>;
+
+struct Concept : decltype(dyno::requires(
+  dyno::CopyConstructible{},
+  "value"_s = dyno::method<int () const>,
+  "next"_s = dyno::method<dyno::T (int) const>,
+  "plus"_s = dyno::function<dyno::T (dyno::T const&, int)>,
+  "make"_s = dyno::function<dyno::T (int)>
+)) { };
+
+template <typename T>
+auto const dyno::default_concept_map<Concept, T> = dyno::make_concept_map(
+  "value"_s = [](T const& self) { return self.value; },
+  "next"_s = [](T const& self, int n) { return T{self.value + n}; },
+  "plus"_s = [](T const& self, int n) { return T{self.value + n}; },
+  "make"_s = [](int n) {
+    if (n < 0)
+      throw std::invalid_argument{"negative"};
+    return T{n};
+  }
+);
+
+template <typename Storage, typename T>
+void test() {
+  using Poly = dyno::poly<Concept, Storage>;
+  Poly const poly{T{1}};
+
+  // The result is constructed in place, without copies or moves.
+  {
+    reset();
+    Poly next = poly.virtual_("next"_s)(2);
+    DYNO_CHECK(constructions == 1);
+    DYNO_CHECK(copies == 0);
+    DYNO_CHECK(moves == 0);
+    DYNO_CHECK(next.virtual_("value"_s)() == 3);
+    DYNO_CHECK(next.template unsafe_get<T>()->value == 3);
+    DYNO_CHECK(poly.virtual_("value"_s)() == 1);
+  }
+
+  // Same with a function taking the `poly` explicitly.
+  {
+    reset();
+    Poly next = poly.virtual_("plus"_s)(poly, 10);
+    DYNO_CHECK(constructions == 1);
+    DYNO_CHECK(copies == 0);
+    DYNO_CHECK(moves == 0);
+    DYNO_CHECK(next.virtual_("value"_s)() == 11);
+  }
+
+  // Same with `bind`, and when chaining calls on the result.
+  {
+    reset();
+    auto next = poly.bind("next"_s);
+    Poly result = next(1).virtual_("next"_s)(1);
+    DYNO_CHECK(constructions == 2);
+    DYNO_CHECK(copies == 0);
+    DYNO_CHECK(moves == 0);
+    DYNO_CHECK(result.virtual_("value"_s)() == 3);
+  }
+
+  // A function that does not take the object at all still creates an object
+  // of the same type as the object held by the `poly`.
+  {
+    reset();
+    Poly made = poly.virtual_("make"_s)(42);
+    DYNO_CHECK(constructions == 1);
+    DYNO_CHECK(made.template unsafe_get<T>()->value == 42);
+  }
+
+  // If the function throws, nothing leaks and the exception is propagated.
+  {
+    bool thrown = false;
+    try {
+      Poly made = poly.virtual_("make"_s)(-1);
+    } catch (std::invalid_argument const&) {
+      thrown = true;
+    }
+    DYNO_CHECK(thrown);
+  }
+
+  // The result can be copied like any other `poly`.
+  {
+    Poly next = poly.virtual_("next"_s)(2);
+    Poly copy{next};
+    DYNO_CHECK(copy.virtual_("value"_s)() == 3);
+  }
+}
+
+int main() {
+  test<dyno::remote_storage, Small>();
+  test<dyno::remote_storage, Large>();
+  test<dyno::sbo_storage<16>, Small>();
+  test<dyno::sbo_storage<16>, Large>();
+  test<dyno::local_storage<128>, Small>();
+  test<dyno::local_storage<128>, Large>();
+  test<dyno::shared_remote_storage, Small>();
+  test<dyno::fallback_storage<dyno::local_storage<16>, dyno::remote_storage>, Small>();
+  test<dyno::fallback_storage<dyno::local_storage<16>, dyno::remote_storage>, Large>();
+
+  // The result uses the vtable of the `poly` the function was called on,
+  // including when it is a local vtable.
+  {
+    using Poly = dyno::poly<Concept, dyno::sbo_storage<16>, dyno::vtable<dyno::local<dyno::everything>>>;
+    Poly const poly{Small{1}};
+    Poly next = poly.virtual_("next"_s)(4);
+    DYNO_CHECK(next.virtual_("value"_s)() == 5);
+  }
+}
@@ -0,0 +1,31 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+using namespace dyno::literals;
+
+
+// This test makes sure that we can't call a function returning `dyno::T` by
+// value on a poly whose storage can't hold the result.
+
+struct Concept : decltype(dyno::requires(
+  "next"_s = dyno::method<dyno::T () const>
+)) { };
+
+struct Foo { };
+
+template <>
+auto const dyno::concept_map<Concept, Foo> = dyno::make_concept_map(
+  "next"_s = [](Foo const&) { return Foo{}; }
+);
+
+int main() {
+  Foo foo;
+  dyno::poly_ref<Concept> ref{foo};
+  // MESSAGE[dyno::poly: Functions returning `dyno::T` by value can only be called]
+  auto next = ref.virtual_("next"_s);
+  (void)next;
+}
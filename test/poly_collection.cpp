@@ -0,0 +1,172 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly_collection.hpp>
+#include <dyno/vtable.hpp>
+
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This test makes sure that `dyno::poly_collection` stores the objects of each
+// type contiguously, and gives access to them in the right order.
+
+struct Shape : decltype(dyno::requires(
+  "name"_s = dyno::method<std::string () const>,
+  "area"_s = dyno::method<int () const>,
+  "grow"_s = dyno::method<void (int)>,
+  "record"_s = dyno::function<void (dyno::T const&, std::vector<std::string>&)>
+)) { };
+
+struct Square { int side; };
+struct Rectangle { int width, height; };
+
+struct Circle {
+  explicit Circle(int r) : radius{r} { ++alive; }
+  Circle(Circle const& other) : radius{other.radius} { ++alive; }
+  ~Circle() { --alive; }
+  int radius;
+  static int alive;
+};
+int Circle::alive = 0;
+
+template <>
+auto const dyno::concept_map<Shape, Square> = dyno::make_concept_map(
+  "name"_s = [](Square const& self) { return "square" + std::to_string(self.side); },
+  "area"_s = [](Square const& self) { return self.side * self.side; },
+  "grow"_s = [](Square& self, int n) { self.side += n; }
+);
+
+template <>
+auto const dyno::concept_map<Shape, Rectangle> = dyno::make_concept_map(
+  "name"_s = [](Rectangle const& self) { return "rectangle" + std::to_string(self.width); },
+  "area"_s = [](Rectangle const& self) { return self.width * self.height; },
+  "grow"_s = [](Rectangle& self, int n) { self.width += n; self.height += n; }
+);
+
+template <>
+auto const dyno::concept_map<Shape, Circle> = dyno::make_concept_map(
+  "name"_s = [](Circle const& self) { return "circle" + std::to_string(self.radius); },
+  "area"_s = [](Circle const& self) { return 3 * self.radius * self.radius; },
+  "grow"_s = [](Circle& self, int n) { self.radius += n; }
+);
+
+template <typename T>
+auto const dyno::default_concept_map<Shape, T> = dyno::make_concept_map(
+  "record"_s = [](T const& self, std::vector<std::string>& out) {
+    out.push_back(dyno::concept_map<Shape, T>["name"_s](self));
+  }
+);
+
+template <typename VTablePolicy>
+void test() {
+  using Collection = dyno::poly_collection<Shape, VTablePolicy>;
+  {
+    Collection shapes;
+    DYNO_CHECK(shapes.empty());
+    DYNO_CHECK(shapes.size() == 0);
+    DYNO_CHECK(shapes.template size<Square>() == 0);
+    DYNO_CHECK(shapes.template begin<Square>() == shapes.template end<Square>());
+
+    shapes.insert(Square{1});
+    shapes.template emplace<Circle>(2);
+    Square square{3};
+    shapes.insert(square);
+    shapes.template emplace<Rectangle>(4, 5);
+    Square& last = shapes.template emplace<Square>(6);
+    DYNO_CHECK(last.side == 6);
+    shapes.template emplace<Circle>(7);
+    DYNO_CHECK(Circle::alive == 2);
+
+    DYNO_CHECK(!shapes.empty());
+    DYNO_CHECK(shapes.size() == 6);
+    DYNO_CHECK(shapes.template size<Square>() == 3);
+    DYNO_CHECK(shapes.template size<Circle>() == 2);
+    DYNO_CHECK(shapes.template size<Rectangle>() == 1);
+
+    // The objects of each type are stored contiguously.
+    {
+      Square* first = shapes.template begin<Square>();
+      DYNO_CHECK(shapes.template end<Square>() - first == 3);
+      DYNO_CHECK(first[0].side == 1 && first[1].side == 3 && first[2].side == 6);
+    }
+
+    // The objects are visited segment by segment, in order of insertion.
+    std::vector<std::string> expected{"square1", "square3", "square6",
+                                      "circle2", "circle7", "rectangle4"};
+    {
+      std::vector<std::string> names;
+      shapes.for_each([&](auto shape) { names.push_back(shape.virtual_("name"_s)()); });
+      DYNO_CHECK(names == expected);
+    }
+
+    // Same thing, but through a const collection.
+    {
+      Collection const& cshapes = shapes;
+      std::vector<std::string> names;
+      cshapes.for_each([&](auto shape) { names.push_back(shape.virtual_("name"_s)()); });
+      DYNO_CHECK(names == expected);
+    }
+
+    // The objects of the specified types are passed with their actual type.
+    {
+      int squares = 0, others = 0;
+      shapes.template for_each<Square>([&](auto&& shape) {
+        if constexpr (std::is_same<std::decay_t<decltype(shape)>, Square>::value)
+          squares += shape.side;
+        else
+          others += shape.virtual_("area"_s)();
+      });
+      DYNO_CHECK(squares == 1 + 3 + 6);
+      DYNO_CHECK(others == 3 * 2 * 2 + 3 * 7 * 7 + 4 * 5);
+    }
+
+    // Calling a function on all the objects, with arguments passed as lvalues.
+    {
+      shapes.invoke_each("grow"_s, 10);
+      std::vector<std::string> names;
+      Collection const& cshapes = shapes;
+      cshapes.invoke_each("record"_s, names);
+      DYNO_CHECK((names == std::vector<std::string>{"square11", "square13", "square16",
+                                                    "circle12", "circle17", "rectangle14"}));
+    }
+
+    // Moving the collection moves the segments without touching the objects.
+    {
+      Square* squares = shapes.template begin<Square>();
+      Collection moved{std::move(shapes)};
+      DYNO_CHECK(moved.size() == 6);
+      DYNO_CHECK(moved.template begin<Square>() == squares);
+      DYNO_CHECK(Circle::alive == 2);
+      shapes = std::move(moved);
+      DYNO_CHECK(shapes.size() == 6);
+    }
+
+    shapes.clear();
+    DYNO_CHECK(shapes.empty());
+    DYNO_CHECK(Circle::alive == 0);
+
+    // Segments are reused after clearing.
+    shapes.insert(Square{8});
+    DYNO_CHECK(shapes.size() == 1);
+    DYNO_CHECK(shapes.template size<Square>() == 1);
+    DYNO_CHECK(shapes.template begin<Square>()->side == 8);
+    shapes.template emplace<Circle>(9);
+  }
+  DYNO_CHECK(Circle::alive == 0);
+}
+
+int main() {
+  test<dyno::vtable<dyno::remote<dyno::everything>>>();
+  test<dyno::vtable<dyno::local<dyno::everything>>>();
+  test<dyno::vtable<dyno::local<dyno::only<decltype("area"_s)>>,
+                    dyno::remote<dyno::everything_else>>>();
+}
@@ -0,0 +1,83 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/storage.hpp>
+using namespace dyno::literals;
+
+
+// This test makes sure that `dyno::poly_ref` and `dyno::poly_cref` can
+// reference objects held by `dyno::poly`s with any storage policy, without
+// copying these objects.
+
+struct Concept : decltype(dyno::requires(
+  "get"_s = dyno::method<int () const>,
+  "set"_s = dyno::method<void (int)>
+)) { };
+
+int copies = 0;
+
+struct Foo {
+  explicit Foo(int v) : value{v} { }
+  Foo(Foo const& other) : value{other.value} { ++copies; }
+  Foo(Foo&& other) : value{other.value} { }
+  int value;
+};
+
+template <>
+auto const dyno::concept_map<Concept, Foo> = dyno::make_concept_map(
+  "get"_s = [](Foo const& self) { return self.value; },
+  "set"_s = [](Foo& self, int v) { self.value = v; }
+);
+
+static_assert(sizeof(dyno::poly_ref<Concept>) == 2 * sizeof(void*));
+static_assert(sizeof(dyno::poly_cref<Concept>) == 2 * sizeof(void*));
+
+int get(dyno::poly_cref<Concept> ref) { return ref.virtual_("get"_s)(); }
+void set(dyno::poly_ref<Concept> ref, int v) { ref.virtual_("set"_s)(v); }
+
+int main() {
+  {
+    dyno::poly<Concept, dyno::remote_storage> remote{Foo{1}};
+    dyno::poly<Concept, dyno::sbo_storage<16>> sbo{Foo{2}};
+    dyno::poly<Concept, dyno::local_storage<16>> local{Foo{3}};
+    copies = 0;
+
+    set(remote, 10);
+    set(sbo, 20);
+    set(local, 30);
+    DYNO_CHECK(get(remote) == 10);
+    DYNO_CHECK(get(sbo) == 20);
+    DYNO_CHECK(get(local) == 30);
+    DYNO_CHECK(copies == 0);
+
+    // The reference points to the object held by the poly.
+    dyno::poly_ref<Concept> ref{sbo};
+    DYNO_CHECK(ref.unsafe_get<Foo>() == sbo.unsafe_get<Foo>());
+
+    // Copying a reference copies the reference, not the object.
+    dyno::poly_ref<Concept> copy{ref};
+    copy.virtual_("set"_s)(200);
+    DYNO_CHECK(sbo.virtual_("get"_s)() == 200);
+
+    // A const reference can be created from a non-const reference.
+    dyno::poly_cref<Concept> cref{ref};
+    DYNO_CHECK(cref.virtual_("get"_s)() == 200);
+    DYNO_CHECK(copies == 0);
+  }
+
+  // Const references can be created from const polys and const objects.
+  {
+    dyno::poly<Concept> const poly{Foo{4}};
+    Foo const foo{5};
+    copies = 0;
+    DYNO_CHECK(get(poly) == 4);
+    DYNO_CHECK(get(foo) == 5);
+    DYNO_CHECK(copies == 0);
+  }
+}
@@ -0,0 +1,20 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno/concept.hpp>
+#include <dyno/poly.hpp>
+
+
+// This test makes sure that we can't create a non-const `dyno::poly_ref`
+// referencing the object held by a const `dyno::poly`.
+
+struct Concept : decltype(dyno::requires()) { };
+
+struct Foo { };
+
+int main() {
+  dyno::poly<Concept> const poly{Foo{}};
+  // MESSAGE[dyno::non_owning_storage: Trying to reference an object held in a const]
+  dyno::poly_ref<Concept> ref{poly};
+}
@@ -0,0 +1,188 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/algorithm.hpp>
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly_slot_map.hpp>
+#include <dyno/vtable.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This test makes sure that `dyno::poly_slot_map` keeps handles valid while
+// objects are inserted and erased, that it detects stale handles, and that it
+// manages the lifetime of the objects it relocates.
+
+struct Entity : decltype(dyno::requires(
+  dyno::MoveConstructible{},
+  "name"_s = dyno::method<std::string () const>,
+  "bump"_s = dyno::method<void (int)>
+)) { };
+
+struct Small { char c; };
+struct Large { double a, b, c; };
+
+struct Tracked {
+  explicit Tracked(std::string s) : text{std::move(s)} { ++alive; }
+  Tracked(Tracked&& other) noexcept : text{std::move(other.text)} { ++alive; ++moves; }
+  ~Tracked() { --alive; }
+  std::string text;
+  static int alive;
+  static int moves;
+};
+int Tracked::alive = 0;
+int Tracked::moves = 0;
+
+static_assert(dyno::storage_info_for<Small>.trivially_relocatable);
+static_assert(dyno::storage_info_for<Large>.trivially_relocatable);
+static_assert(!dyno::storage_info_for<Tracked>.trivially_relocatable);
+
+template <>
+auto const dyno::concept_map<Entity, Small> = dyno::make_concept_map(
+  "name"_s = [](Small const& self) { return "small" + std::to_string(self.c); },
+  "bump"_s = [](Small& self, int n) { self.c += n; }
+);
+
+template <>
+auto const dyno::concept_map<Entity, Large> = dyno::make_concept_map(
+  "name"_s = [](Large const& self) { return "large" + std::to_string(int(self.a)); },
+  "bump"_s = [](Large& self, int n) { self.a += n; }
+);
+
+template <>
+auto const dyno::concept_map<Entity, Tracked> = dyno::make_concept_map(
+  "name"_s = [](Tracked const& self) { return "tracked" + self.text; },
+  "bump"_s = [](Tracked& self, int n) { self.text += std::to_string(n); }
+);
+
+template <typename VTablePolicy>
+void test() {
+  using Map = dyno::poly_slot_map<Entity, VTablePolicy>;
+  using Handle = typename Map::handle;
+  {
+    Map map;
+    DYNO_CHECK(map.empty());
+    DYNO_CHECK(map.begin() == map.end());
+
+    Handle small = map.insert(Small{1});
+    Handle large = map.insert(Large{2, 0, 0});
+    Handle tracked = map.template emplace<Tracked>("a");
+    DYNO_CHECK(map.size() == 3);
+    DYNO_CHECK(Tracked::alive == 1);
+    DYNO_CHECK(map.contains(small) && map.contains(large) && map.contains(tracked));
+    DYNO_CHECK(map[small].virtual_("name"_s)() == "small1");
+    DYNO_CHECK(map[large].virtual_("name"_s)() == "large2");
+    DYNO_CHECK(map[tracked].virtual_("name"_s)() == "trackeda");
+
+    // The objects are stored next to each other, in cells of the same size.
+    {
+      auto address = [&](Handle h) {
+        return reinterpret_cast<std::uintptr_t>(map[h].template unsafe_get<void>());
+      };
+      std::uintptr_t stride = address(large) - address(small);
+      DYNO_CHECK(stride >= sizeof(Tracked) && stride >= sizeof(Large));
+      DYNO_CHECK(address(tracked) - address(large) == stride);
+    }
+
+    // Many more objects, so that the buffer grows.
+    std::vector<Handle> handles;
+    for (int i = 0; i != 100; ++i) {
+      if (i % 2 == 0)
+        handles.push_back(map.insert(Small{char(i)}));
+      else
+        handles.push_back(map.template emplace<Tracked>(std::to_string(i)));
+    }
+    DYNO_CHECK(map.size() == 103);
+    DYNO_CHECK(Tracked::alive == 51);
+    for (int i = 0; i != 100; ++i) {
+      std::string expected = i % 2 == 0 ? "small" + std::to_string(i)
+                                        : "tracked" + std::to_string(i);
+      DYNO_CHECK(map[handles[i]].virtual_("name"_s)() == expected);
+    }
+
+    // Erasing an object relocates the last object to its cell, which keeps
+    // all the handles valid.
+    DYNO_CHECK(map.erase(large));
+    DYNO_CHECK(!map.contains(large));
+    DYNO_CHECK(!map.erase(large));
+    DYNO_CHECK(map.size() == 102);
+    DYNO_CHECK(map.handle_at(1) == handles.back());
+    DYNO_CHECK(map[handles.back()].virtual_("name"_s)() == "tracked99");
+
+    Tracked::moves = 0;
+    DYNO_CHECK(map.erase(tracked));
+    DYNO_CHECK(Tracked::alive == 50);
+    DYNO_CHECK(Tracked::moves == 0); // the last object is a `Small`
+    DYNO_CHECK(map.erase(handles[1]));
+    DYNO_CHECK(Tracked::alive == 49);
+    DYNO_CHECK(Tracked::moves == 1); // the last object is a `Tracked`
+    for (int i = 0; i != 100; ++i) {
+      if (i == 1)
+        continue;
+      std::string expected = i % 2 == 0 ? "small" + std::to_string(i)
+                                        : "tracked" + std::to_string(i);
+      DYNO_CHECK(map[handles[i]].virtual_("name"_s)() == expected);
+    }
+
+    // A slot is reused with another generation, so stale handles don't refer
+    // to the new object.
+    Handle reused = map.insert(Small{7});
+    DYNO_CHECK(reused.index == handles[1].index || reused.index == tracked.index);
+    DYNO_CHECK(reused != handles[1] && reused != tracked);
+    DYNO_CHECK(!map.contains(handles[1]) && !map.contains(tracked));
+    DYNO_CHECK(map[reused].virtual_("name"_s)() == "small7");
+
+    // Iterating visits each object once, in the order of the buffer.
+    {
+      dyno::invoke_each(map, "bump"_s, 1);
+      std::size_t visited = 0;
+      Map const& cmap = map;
+      for (auto entity : cmap) {
+        DYNO_CHECK(entity.virtual_("name"_s)() == cmap[cmap.handle_at(visited)].virtual_("name"_s)());
+        ++visited;
+      }
+      DYNO_CHECK(visited == map.size());
+      DYNO_CHECK(cmap[small].virtual_("name"_s)() == "small2");
+      DYNO_CHECK(cmap[handles[3]].virtual_("name"_s)() == "tracked31");
+    }
+
+    // Moving the map moves the buffer, not the objects.
+    {
+      void* first = map[small].template unsafe_get<void>();
+      Map moved{std::move(map)};
+      DYNO_CHECK(map.empty());
+      DYNO_CHECK(!map.contains(small));
+      DYNO_CHECK(moved[small].template unsafe_get<void>() == first);
+      map = std::move(moved);
+      DYNO_CHECK(map.contains(small));
+    }
+
+    std::size_t size = map.size();
+    map.clear();
+    DYNO_CHECK(map.empty());
+    DYNO_CHECK(Tracked::alive == 0);
+    DYNO_CHECK(!map.contains(small) && !map.contains(handles[0]));
+
+    // The slots are reused after clearing; 103 slots were created so far.
+    for (std::size_t i = 0; i != size; ++i)
+      DYNO_CHECK(map.template emplace<Tracked>("again").index < 103);
+    DYNO_CHECK(map.size() == size);
+    DYNO_CHECK(Tracked::alive == int(size));
+  }
+  DYNO_CHECK(Tracked::alive == 0);
+}
+
+int main() {
+  test<dyno::vtable<dyno::remote<dyno::everything>>>();
+  test<dyno::vtable<dyno::local<dyno::everything>>>();
+}
@@ -0,0 +1,36 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly_slot_map.hpp>
+using namespace dyno::literals;
+
+
+// This test makes sure that we can't insert an object whose move constructor
+// may throw in a `dyno::poly_slot_map`, since the objects are relocated when
+// objects are erased and when the map grows, and that must not fail half-way.
+
+struct Concept : decltype(dyno::requires(
+  dyno::MoveConstructible{},
+  "f"_s = dyno::method<int () const>
+)) { };
+
+struct Foo {
+  Foo() = default;
+  Foo(Foo&&) { }
+  ~Foo() { }
+};
+
+template <>
+auto const dyno::concept_map<Concept, Foo> = dyno::make_concept_map(
+  "f"_s = [](Foo const&) { return 111; }
+);
+
+int main() {
+  dyno::poly_slot_map<Concept> map;
+  // MESSAGE[dyno::poly_slot_map: Trying to insert an object whose move constructor may throw]
+  map.emplace<Foo>();
+}
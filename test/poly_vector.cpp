@@ -0,0 +1,181 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/algorithm.hpp>
+#include <dyno/builtin.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly_vector.hpp>
+#include <dyno/vtable.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This test makes sure that `dyno::poly_vector` packs objects of different
+// sizes and alignments in a single buffer, in order of insertion, and that it
+// manages their lifetime properly.
+
+struct Event : decltype(dyno::requires(
+  dyno::MoveConstructible{},
+  "describe"_s = dyno::method<std::string () const>,
+  "bump"_s = dyno::method<void (int)>
+)) { };
+
+struct Click { char button; };
+struct Move { double x, y; };
+struct Key { std::int16_t code; };
+
+struct Text {
+  explicit Text(std::string s) : text{std::move(s)} { ++alive; }
+  Text(Text&& other) noexcept : text{std::move(other.text)} { ++alive; }
+  ~Text() { --alive; }
+  std::string text;
+  static int alive;
+};
+int Text::alive = 0;
+
+template <>
+auto const dyno::concept_map<Event, Click> = dyno::make_concept_map(
+  "describe"_s = [](Click const& self) { return "click" + std::to_string(self.button); },
+  "bump"_s = [](Click& self, int n) { self.button += n; }
+);
+
+template <>
+auto const dyno::concept_map<Event, Move> = dyno::make_concept_map(
+  "describe"_s = [](Move const& self) { return "move" + std::to_string(int(self.x + self.y)); },
+  "bump"_s = [](Move& self, int n) { self.x += n; }
+);
+
+template <>
+auto const dyno::concept_map<Event, Key> = dyno::make_concept_map(
+  "describe"_s = [](Key const& self) { return "key" + std::to_string(self.code); },
+  "bump"_s = [](Key& self, int n) { self.code += n; }
+);
+
+template <>
+auto const dyno::concept_map<Event, Text> = dyno::make_concept_map(
+  "describe"_s = [](Text const& self) { return "text" + self.text; },
+  "bump"_s = [](Text& self, int n) { self.text += std::to_string(n); }
+);
+
+template <typename Vector>
+std::vector<std::string> describe(Vector const& events) {
+  std::vector<std::string> result;
+  for (auto event : events)
+    result.push_back(event.virtual_("describe"_s)());
+  return result;
+}
+
+template <typename VTablePolicy>
+void test() {
+  using Vector = dyno::poly_vector<Event, VTablePolicy>;
+  {
+    Vector events;
+    DYNO_CHECK(events.empty());
+    DYNO_CHECK(events.size() == 0);
+    DYNO_CHECK(events.begin() == events.end());
+
+    // The objects are packed at their own alignment, in order of insertion.
+    events.push_back(Click{1});
+    DYNO_CHECK(events.bytes() == sizeof(Click));
+    events.push_back(Key{2});
+    DYNO_CHECK(events.bytes() == alignof(Key) + sizeof(Key));
+    events.push_back(Click{3});
+    events.push_back(Move{4, 5});
+    std::size_t expected_bytes = (alignof(Key) + sizeof(Key) + sizeof(Click) + alignof(Move) - 1)
+                                 / alignof(Move) * alignof(Move) + sizeof(Move);
+    DYNO_CHECK(events.bytes() == expected_bytes);
+    Text& text = events.template emplace_back<Text>("hello");
+    DYNO_CHECK(text.text == "hello");
+    DYNO_CHECK(Text::alive == 1);
+    DYNO_CHECK(events.size() == 5);
+
+    // Many more objects, so that the buffer grows and the objects are moved.
+    for (int i = 0; i != 100; ++i) {
+      if (i % 2 == 0)
+        events.push_back(Key{std::int16_t(i)});
+      else
+        events.template emplace_back<Text>(std::to_string(i));
+    }
+    DYNO_CHECK(events.size() == 105);
+    DYNO_CHECK(Text::alive == 51);
+    DYNO_CHECK(events.bytes() <= events.capacity_bytes());
+
+    std::vector<std::string> expected{"click1", "key2", "click3", "move9", "texthello"};
+    for (int i = 0; i != 100; ++i)
+      expected.push_back(i % 2 == 0 ? "key" + std::to_string(i) : "text" + std::to_string(i));
+    DYNO_CHECK(describe(events) == expected);
+
+    // Each object is correctly aligned.
+    auto address = [&](std::size_t i) {
+      return reinterpret_cast<std::uintptr_t>(events[i].template unsafe_get<void>());
+    };
+    DYNO_CHECK(address(0) % alignof(std::max_align_t) == 0);
+    DYNO_CHECK(address(1) % alignof(Key) == 0);
+    DYNO_CHECK(address(3) % alignof(Move) == 0);
+    DYNO_CHECK(address(4) % alignof(Text) == 0);
+    for (std::size_t i = 5; i != events.size(); ++i)
+      DYNO_CHECK(address(i) % (i % 2 == 1 ? alignof(Key) : alignof(Text)) == 0);
+
+    // Calling a function on each object, in order.
+    dyno::invoke_each(events, "bump"_s, 1);
+    DYNO_CHECK(events[0].virtual_("describe"_s)() == "click2");
+    DYNO_CHECK(events[3].virtual_("describe"_s)() == "move10");
+    DYNO_CHECK(events[4].virtual_("describe"_s)() == "texthello1");
+    DYNO_CHECK(events[104].virtual_("describe"_s)() == "text991");
+
+    // Through a const vector.
+    {
+      Vector const& cevents = events;
+      DYNO_CHECK(cevents[1].virtual_("describe"_s)() == "key3");
+      DYNO_CHECK(describe(cevents).size() == 105);
+    }
+
+    // Removing objects from the end reuses their memory.
+    std::size_t bytes = events.bytes();
+    events.pop_back();
+    DYNO_CHECK(events.size() == 104);
+    DYNO_CHECK(Text::alive == 50);
+    DYNO_CHECK(events.bytes() < bytes);
+    events.template emplace_back<Text>("again");
+    DYNO_CHECK(events.bytes() == bytes);
+    DYNO_CHECK(events[104].virtual_("describe"_s)() == "textagain");
+
+    // Moving the vector moves the buffer, not the objects.
+    {
+      void* first = events[0].template unsafe_get<void>();
+      Vector moved{std::move(events)};
+      DYNO_CHECK(events.empty());
+      DYNO_CHECK(moved.size() == 105);
+      DYNO_CHECK(moved[0].template unsafe_get<void>() == first);
+      DYNO_CHECK(Text::alive == 51);
+      events = std::move(moved);
+      DYNO_CHECK(events.size() == 105);
+      DYNO_CHECK(moved.empty());
+    }
+
+    events.clear();
+    DYNO_CHECK(events.empty());
+    DYNO_CHECK(events.bytes() == 0);
+    DYNO_CHECK(Text::alive == 0);
+
+    events.template emplace_back<Text>("last");
+    events.push_back(Move{1, 2});
+  }
+  DYNO_CHECK(Text::alive == 0);
+}
+
+int main() {
+  test<dyno::vtable<dyno::remote<dyno::everything>>>();
+  test<dyno::vtable<dyno::local<dyno::everything>>>();
+  test<dyno::vtable<dyno::local<dyno::only<decltype("describe"_s)>>,
+                    dyno::remote<dyno::everything_else>>>();
+}
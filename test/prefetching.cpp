@@ -0,0 +1,95 @@
+// Copyright Louis Dionne 2017
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at http://boost.org/LICENSE_1_0.txt)
+
+#include "testing.hpp"
+
+#include <dyno/algorithm.hpp>
+#include <dyno/concept.hpp>
+#include <dyno/concept_map.hpp>
+#include <dyno/poly.hpp>
+#include <dyno/poly_vector.hpp>
+#include <dyno/storage.hpp>
+#include <dyno/vtable.hpp>
+
+#include <cstddef>
+#include <vector>
+using namespace dyno::literals;
+
+
+// This test makes sure that `dyno::prefetching` visits the same elements as
+// the underlying range, in the same order, whatever the prefetch distance.
+
+struct Concept : decltype(dyno::requires(
+  dyno::MoveConstructible{},
+  "value"_s = dyno::method<int () const>,
+  "add"_s = dyno::method<void (int)>
+)) { };
+
+struct A { int value; };
+struct B { int value; };
+
+template <typename T>
+auto const dyno::default_concept_map<Concept, T> = dyno::make_concept_map(
+  "value"_s = [](T const& self) { return self.value; },
+  "add"_s = [](T& self, int n) { self.value += n; }
+);
+
+template <typename Sequence>
+void test(Sequence& polys) {
+  for (int i = 0; i != 20; ++i) {
+    if (i % 3 == 0)
+      polys.push_back(A{i});
+    else
+      polys.push_back(B{i});
+  }
+
+  for (std::size_t distance : {0, 1, 4, 19, 20, 100}) {
+    auto view = dyno::prefetching(polys, distance);
+    // The view can be iterated over more than once.
+    for (int pass = 0; pass != 2; ++pass) {
+      std::vector<int> values;
+      for (auto&& poly : view)
+        values.push_back(poly.virtual_("value"_s)());
+      DYNO_CHECK(values.size() == 20);
+      for (int i = 0; i != 20; ++i)
+        DYNO_CHECK(values[i] == i);
+    }
+  }
+
+  dyno::invoke_each(dyno::prefetching(polys, 3), "add"_s, 100);
+  for (auto&& poly : polys)
+    DYNO_CHECK(poly.virtual_("value"_s)() >= 100);
+
+  Sequence empty;
+  for (auto&& poly : dyno::prefetching(empty)) {
+    (void)poly;
+    DYNO_CHECK(false);
+  }
+}
+
+int main() {
+  {
+    std::vector<dyno::poly<Concept, dyno::remote_storage>> polys;
+    test(polys);
+  }
+  {
+    std::vector<dyno::poly<Concept, dyno::sbo_storage<4>>> polys;
+    test(polys);
+  }
+  {
+    std::vector<dyno::poly<Concept, dyno::remote_storage,
+                           dyno::vtable<dyno::local<dyno::everything>>>> polys;
+    test(polys);
+  }
+  {
+    std::vector<dyno::poly<Concept, dyno::remote_storage,
+                           dyno::vtable<dyno::local<dyno::only<decltype("add"_s)>>,
+                                        dyno::remote<dyno::everything_else>>>> polys;
+    test(polys);
+  }
+  {
+    dyno::poly_vector<Concept> polys;
+    test(polys);
+  }
+}